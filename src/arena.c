@@ -0,0 +1,54 @@
+#include "arena.h"
+#include <sys/mman.h>
+
+
+void arena_init(struct Arena* arena, size_t size) {
+  void* base = mmap(
+      NULL,
+      size,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+      -1,
+      0
+  );
+  if (base == MAP_FAILED) {
+    log_fatal_f("mmap(%zu) failed (%d): %s\n", size, errno, strerror(errno));
+  }
+  arena->base = base;
+  arena->size = size;
+  arena->used = 0;
+}
+
+
+/**
+ * Memory comes zeroed from the system. `alignment` must be a power of 2.
+ */
+void* arena_allocate(struct Arena* arena, size_t size, size_t alignment) {
+  size_t start = (arena->used + alignment - 1) & ~(alignment - 1);
+  if (start + size > arena->size) {
+    log_fatal_f("Arena of %zu bytes is full, %zu more requested.\n", arena->size, size);
+  }
+  arena->used = start + size;
+  return arena->base + start;
+}
+
+
+/**
+ * Free everything allocated, in one call whatever the number of
+ * allocations. The pages go back to the system and read as zero again.
+ */
+void arena_reset(struct Arena* arena) {
+  if (arena->used > 0 && madvise(arena->base, arena->used, MADV_DONTNEED) == -1) {
+    log_error_f("madvise() failed (%d): %s", errno, strerror(errno));
+  }
+  arena->used = 0;
+}
+
+
+void arena_close(struct Arena* arena) {
+  if (arena->base == NULL) return;
+  munmap(arena->base, arena->size);
+  arena->base = NULL;
+  arena->size = 0;
+  arena->used = 0;
+}
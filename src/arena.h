@@ -0,0 +1,27 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+
+#include <stddef.h>
+#include "log.h"
+
+
+/**
+ * Bump allocator over its own anonymous mapping. The whole size is only
+ * reserved: pages cost memory once touched, and a reset gives them back
+ * to the system at once whatever was allocated.
+ */
+struct Arena {
+  char* base;
+  size_t size;
+  size_t used;
+};
+
+
+void arena_init(struct Arena* arena, size_t size);
+void* arena_allocate(struct Arena* arena, size_t size, size_t alignment);
+void arena_reset(struct Arena* arena);
+void arena_close(struct Arena* arena);
+
+
+#endif
@@ -0,0 +1,173 @@
+#include "bench.h"
+
+
+struct Bench {
+  struct RenderFramebuffer framebuffer;
+  struct RenderBackend render_backend;
+  struct UI ui;
+  struct Game game;
+  struct CommandStream command_stream;
+};
+
+
+struct BenchBoardSize {
+  int width;
+  int height;
+};
+
+
+// The board sizes offered by the menu.
+const struct BenchBoardSize g_bench_board_sizes[] = {
+  {GAME_BOARD_EASY_WIDTH, GAME_BOARD_EASY_HEIGHT},
+  {GAME_BOARD_MEDIUM_WIDTH, GAME_BOARD_MEDIUM_HEIGHT},
+  {GAME_BOARD_HARD_WIDTH, GAME_BOARD_HARD_HEIGHT}
+};
+
+
+struct Bench g_bench;
+
+
+double bench_elapsed_ns(struct timespec* start, struct timespec* end) {
+  return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+
+/**
+ * Headless in game setup with a deterministic board.
+ */
+void bench_init(struct Bench* bench) {
+  srand(BENCH_SEED);
+  render_framebuffer_init(
+      &bench->render_backend,
+      &bench->framebuffer,
+      BENCH_TERMINAL_WIDTH,
+      BENCH_TERMINAL_HEIGHT
+  );
+  ui_init(&bench->ui, &bench->render_backend);
+  game_init_hard_mode(&bench->game);
+  game_set_game_state(&bench->game, GAME_STATE_IN_GAME);
+  bench->ui.minimap.enable = true;
+}
+
+
+/**
+ * Render frames while walking the cursor over the board.
+ * Prints the time, cells and bytes per frame.
+ */
+void bench_render(int frame_count) {
+  struct Bench* bench = &g_bench;
+  bench_init(bench);
+  struct GameBoard* game_board = &bench->game.game_board;
+  struct Cursor* cursor = &bench->game.cursor;
+
+  struct timespec start;
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int frame = 0; frame < frame_count; frame++) {
+    game_board_move_cursor(game_board, cursor, 1, frame % game_board->width == 0);
+    render(&bench->ui, &bench->game);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  struct RenderStats* stats = &bench->render_backend.total_stats;
+  long frames = stats->frames > 0 ? stats->frames : 1;
+  printf(
+      "render: backend=%s frames=%ld ns/frame=%.0f cells/frame=%.1f bytes/frame=%.1f\n",
+      bench->render_backend.name,
+      stats->frames,
+      bench_elapsed_ns(&start, &end) / frames,
+      (double)stats->cells / frames,
+      (double)stats->bytes / frames
+  );
+}
+
+
+/**
+ * Pick the next move of a simple bot: mostly reveal frontier cells, flag
+ * some of them and chord at random.
+ */
+enum CommandStreamCommand bench_simulate_move(struct GameBoard* game_board, int64_t* arguments) {
+  int cell_count = game_board_get_cell_count(game_board);
+  int cell = rand() % cell_count;
+  cell = game_board_get_index(game_board, cell % game_board->width, cell / game_board->width);
+  int choice = rand() % 10;
+  enum CommandStreamCommand command = COMMAND_STREAM_COMMAND_REVEAL;
+  if (choice >= 6 && choice < 8) command = COMMAND_STREAM_COMMAND_FLAG;
+  if (choice >= 8) command = COMMAND_STREAM_COMMAND_CHORD;
+  if (command != COMMAND_STREAM_COMMAND_CHORD) {
+    game_board_find_target(game_board, GAME_BOARD_TARGET_FRONTIER, cell, 1, &cell);
+  }
+  arguments[0] = game_board_get_column(game_board, cell);
+  arguments[1] = game_board_get_line(game_board, cell);
+  return command;
+}
+
+
+/**
+ * Play games on the menu board sizes through the command stream, without
+ * any rendering. Prints the time per move.
+ */
+void bench_simulate(int game_count) {
+  struct CommandStream* command_stream = &g_bench.command_stream;
+  command_stream_init(command_stream, -1, -1, false);
+  struct GameBoard* game_board = command_stream->session->game_board;
+  srand(BENCH_SEED);
+
+  long move_count = 0;
+  int won_count = 0;
+  struct timespec start;
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int game = 0; game < game_count; game++) {
+    const struct BenchBoardSize* size =
+      &g_bench_board_sizes[game % array_size(g_bench_board_sizes)];
+    int64_t arguments[COMMAND_STREAM_ARGUMENT_MAX] = {
+      size->width,
+      size->height,
+      BENCH_SIMULATE_DENSITY,
+      rand()
+    };
+    command_stream_execute(command_stream, COMMAND_STREAM_COMMAND_NEW, arguments);
+
+    enum CommandStreamStatus status = COMMAND_STREAM_STATUS_PLAYING;
+    arguments[0] = size->width / 2;
+    arguments[1] = size->height / 2;
+    enum CommandStreamCommand command = COMMAND_STREAM_COMMAND_REVEAL;
+    for (int move = 0; move < BENCH_SIMULATE_MOVES_MAX; move++) {
+      status = command_stream_execute(command_stream, command, arguments);
+      move_count++;
+      if (status == COMMAND_STREAM_STATUS_WON || status == COMMAND_STREAM_STATUS_LOST) break;
+      command = bench_simulate_move(game_board, arguments);
+    }
+    if (status == COMMAND_STREAM_STATUS_WON) won_count++;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  command_stream_close(command_stream);
+
+  printf(
+      "simulate: games=%d won=%d moves=%ld ns/move=%.0f\n",
+      game_count,
+      won_count,
+      move_count,
+      bench_elapsed_ns(&start, &end) / (move_count > 0 ? move_count : 1)
+  );
+}
+
+
+/**
+ * Print a single in game frame. The output only changes when rendering
+ * changes, so it can be compared against a saved frame.
+ */
+void bench_render_frame(FILE* file) {
+  struct Bench* bench = &g_bench;
+  bench_init(bench);
+  struct GameBoard* game_board = &bench->game.game_board;
+  game_board_play_cell(
+      game_board,
+      game_board->width / 2,
+      game_board->height / 2,
+      &bench->game.delta
+  );
+  render(&bench->ui, &bench->game);
+  render_framebuffer_dump(&bench->framebuffer, file);
+}
@@ -0,0 +1,27 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+
+#include <stdio.h>
+#include <time.h>
+#include "game.h"
+#include "render.h"
+#include "render_framebuffer.h"
+#include "command_stream.h"
+
+
+#define BENCH_SEED 42
+#define BENCH_RENDER_FRAMES 10000
+#define BENCH_TERMINAL_WIDTH 120
+#define BENCH_TERMINAL_HEIGHT 40
+#define BENCH_SIMULATE_GAMES 20000
+#define BENCH_SIMULATE_MOVES_MAX 2000
+#define BENCH_SIMULATE_DENSITY 10
+
+
+void bench_render(int frame_count);
+void bench_render_frame(FILE* file);
+void bench_simulate(int game_count);
+
+
+#endif
@@ -0,0 +1,410 @@
+#include "command_stream.h"
+#include <unistd.h>
+
+
+#define COMMAND_STREAM_NUMBER_MAX 0xffffffffLL
+// Worst case of one text reply: status plus "xx,yy,c" per cell.
+#define COMMAND_STREAM_REPLY_MAX (2 + GAME_BOARD_SIZE_MAX * 8)
+#define COMMAND_STREAM_GLYPH_HIDDEN '#'
+#define COMMAND_STREAM_GLYPH_EMPTY '.'
+#define COMMAND_STREAM_GLYPH_MINE '*'
+
+
+void command_stream_init(
+    struct CommandStream* command_stream,
+    int input_fd,
+    int output_fd,
+    bool binary
+) {
+  command_stream->input_fd = input_fd;
+  command_stream->output_fd = output_fd;
+  command_stream->binary = binary;
+  command_stream->input_start = 0;
+  command_stream->input_end = 0;
+  command_stream->output_size = 0;
+  command_stream->command_count = 0;
+  session_table_init(&command_stream->sessions);
+  command_stream->session = session_table_open(&command_stream->sessions, 0);
+}
+
+
+void command_stream_close(struct CommandStream* command_stream) {
+  session_table_close(&command_stream->sessions);
+  command_stream->session = NULL;
+}
+
+
+void command_stream_flush(struct CommandStream* command_stream) {
+  int written = 0;
+  while (written < command_stream->output_size) {
+    ssize_t result = write(
+        command_stream->output_fd,
+        command_stream->output + written,
+        command_stream->output_size - written
+    );
+    if (result < 0) {
+      if (errno == EINTR) continue;
+      log_fatal_f("write() failed (%d): %s\n", errno, strerror(errno));
+    }
+    written += result;
+  }
+  command_stream->output_size = 0;
+}
+
+
+/**
+ * Make room for a reply of up to `size` bytes.
+ */
+char* command_stream_reserve(struct CommandStream* command_stream, int size) {
+  if (command_stream->output_size + size > COMMAND_STREAM_BUFFER_SIZE) {
+    command_stream_flush(command_stream);
+  }
+  return command_stream->output + command_stream->output_size;
+}
+
+
+enum CommandStreamStatus command_stream_get_status(struct GameBoard* game_board) {
+  if (game_board_is_lost(game_board)) return COMMAND_STREAM_STATUS_LOST;
+  if (game_board_is_win(game_board)) return COMMAND_STREAM_STATUS_WON;
+  return COMMAND_STREAM_STATUS_PLAYING;
+}
+
+
+char command_stream_get_glyph(struct GameBoard* game_board, int index) {
+  if (!game_board->visibility_map[index]) {
+    char marker = game_board->markers[index];
+    if (marker == BOARD_CELL_TYPE_MINE_MARKER || marker == BOARD_CELL_TYPE_OK_MARKER) {
+      return marker;
+    }
+    return COMMAND_STREAM_GLYPH_HIDDEN;
+  }
+  char cell = game_board->board[index];
+  if (cell == BOARD_CELL_TYPE_EMPTY) return COMMAND_STREAM_GLYPH_EMPTY;
+  if (cell == BOARD_CELL_TYPE_MINE) return COMMAND_STREAM_GLYPH_MINE;
+  return '0' + cell;
+}
+
+
+char* command_stream_format_int(char* output, int value) {
+  if (value >= 10) *output++ = '0' + value / 10;
+  *output++ = '0' + value % 10;
+  return output;
+}
+
+
+/**
+ * Write the status and the cells changed by the last command.
+ */
+void command_stream_write_reply(
+    struct CommandStream* command_stream,
+    enum CommandStreamStatus status
+) {
+  struct Session* session = command_stream->session;
+  struct GameBoard* game_board = session->game_board;
+  struct GameBoardDelta* delta = session->delta;
+  // An ended session has no delta left.
+  int change_count = status == COMMAND_STREAM_STATUS_ERROR || !session->is_open ? 0 : delta->count;
+  char* start = command_stream_reserve(command_stream, COMMAND_STREAM_REPLY_MAX);
+  char* output = start;
+
+  if (command_stream->binary) {
+    *output++ = status;
+    *output++ = change_count & 0xff;
+    *output++ = change_count >> 8;
+    for (int i = 0; i < change_count; i++) {
+      int index = delta->cells[i];
+      *output++ = game_board_get_column(game_board, index);
+      *output++ = game_board_get_line(game_board, index);
+      *output++ = command_stream_get_glyph(game_board, index);
+    }
+  } else {
+    *output++ = status;
+    for (int i = 0; i < change_count; i++) {
+      int index = delta->cells[i];
+      *output++ = ' ';
+      output = command_stream_format_int(output, game_board_get_column(game_board, index));
+      *output++ = ',';
+      output = command_stream_format_int(output, game_board_get_line(game_board, index));
+      *output++ = ',';
+      *output++ = command_stream_get_glyph(game_board, index);
+    }
+    *output++ = '\n';
+  }
+
+  command_stream->output_size += output - start;
+}
+
+
+enum CommandStreamStatus command_stream_new_game(
+    struct CommandStream* command_stream,
+    const int64_t* arguments
+) {
+  int64_t width = arguments[0];
+  int64_t height = arguments[1];
+  int64_t density = arguments[2];
+  if (width < 1 || width > GAME_BOARD_WIDTH_MAX) return COMMAND_STREAM_STATUS_ERROR;
+  if (height < 1 || height > GAME_BOARD_HEIGHT_MAX) return COMMAND_STREAM_STATUS_ERROR;
+  if (density < 0 || density > 100) return COMMAND_STREAM_STATUS_ERROR;
+
+  struct GameBoard* game_board = command_stream->session->game_board;
+  game_board_init(game_board, width, height);
+  game_board_setup_game(game_board, density, (unsigned int)arguments[3]);
+  return COMMAND_STREAM_STATUS_PLAYING;
+}
+
+
+enum CommandStreamStatus command_stream_switch_session(
+    struct CommandStream* command_stream,
+    int64_t id
+) {
+  struct Session* session = session_table_open(
+      &command_stream->sessions,
+      id < SESSION_MAX ? id : -1
+  );
+  if (session == NULL) return COMMAND_STREAM_STATUS_ERROR;
+  command_stream->session = session;
+  game_board_delta_clear(session->delta);
+  return COMMAND_STREAM_STATUS_PLAYING;
+}
+
+
+/**
+ * Run one command against the board. The cells it changed are left in the
+ * command stream delta.
+ */
+enum CommandStreamStatus command_stream_execute(
+    struct CommandStream* command_stream,
+    enum CommandStreamCommand command,
+    const int64_t* arguments
+) {
+  struct Session* session = command_stream->session;
+  command_stream->command_count++;
+  if (session->is_open) game_board_delta_clear(session->delta);
+
+  if (command == COMMAND_STREAM_COMMAND_SESSION) {
+    return command_stream_switch_session(command_stream, arguments[0]);
+  }
+  if (command == COMMAND_STREAM_COMMAND_END) {
+    int id = arguments[0] < SESSION_MAX ? arguments[0] : -1;
+    if (!session_table_end(&command_stream->sessions, id)) return COMMAND_STREAM_STATUS_ERROR;
+    return COMMAND_STREAM_STATUS_PLAYING;
+  }
+  if (!session->is_open) return COMMAND_STREAM_STATUS_ERROR;
+  if (command == COMMAND_STREAM_COMMAND_NEW) {
+    return command_stream_new_game(command_stream, arguments);
+  }
+
+  struct GameBoard* game_board = session->game_board;
+  struct GameBoardDelta* delta = session->delta;
+  int64_t x = arguments[0];
+  int64_t y = arguments[1];
+  if (x < 0 || x >= game_board->width) return COMMAND_STREAM_STATUS_ERROR;
+  if (y < 0 || y >= game_board->height) return COMMAND_STREAM_STATUS_ERROR;
+
+  switch (command) {
+    case COMMAND_STREAM_COMMAND_REVEAL:
+      game_board_play_cell(game_board, x, y, delta);
+      break;
+    case COMMAND_STREAM_COMMAND_FLAG:
+      // Markers on revealed cells mean nothing and would be reported as reveals.
+      if (game_board->visibility_map[game_board_get_index(game_board, x, y)]) {
+        return COMMAND_STREAM_STATUS_ERROR;
+      }
+      game_board_switch_mine_marker(game_board, x, y, delta);
+      break;
+    case COMMAND_STREAM_COMMAND_CHORD:
+      game_board_chord(game_board, x, y, delta);
+      break;
+    default:
+      return COMMAND_STREAM_STATUS_ERROR;
+  }
+
+  return command_stream_get_status(game_board);
+}
+
+
+int command_stream_get_argument_count(enum CommandStreamCommand command) {
+  switch (command) {
+    case COMMAND_STREAM_COMMAND_REVEAL:
+    case COMMAND_STREAM_COMMAND_FLAG:
+    case COMMAND_STREAM_COMMAND_CHORD:
+      return 2;
+    case COMMAND_STREAM_COMMAND_NEW:
+      return 4;
+    case COMMAND_STREAM_COMMAND_SESSION:
+    case COMMAND_STREAM_COMMAND_END:
+      return 1;
+    default:
+      return -1;
+  }
+}
+
+
+// Bytes of a binary argument.
+int command_stream_get_argument_size(enum CommandStreamCommand command, int argument) {
+  switch (command) {
+    case COMMAND_STREAM_COMMAND_NEW:
+      return argument == 3 ? 4 : 1;
+    case COMMAND_STREAM_COMMAND_SESSION:
+    case COMMAND_STREAM_COMMAND_END:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+
+void command_stream_run_command(
+    struct CommandStream* command_stream,
+    enum CommandStreamCommand command,
+    const int64_t* arguments
+) {
+  enum CommandStreamStatus status = command_stream_execute(command_stream, command, arguments);
+  command_stream_write_reply(command_stream, status);
+}
+
+
+/**
+ * Parse and run one text line, without its line feed.
+ */
+void command_stream_run_line(struct CommandStream* command_stream, const char* line, int length) {
+  const char* end = line + length;
+  while (line < end && (*line == ' ' || *line == '\t' || *line == '\r')) line++;
+  if (line == end || *line == '#') return;
+
+  enum CommandStreamCommand command = *line;
+  int argument_count = command_stream_get_argument_count(command);
+  while (line < end && *line != ' ' && *line != '\t') line++;
+
+  int64_t arguments[COMMAND_STREAM_ARGUMENT_MAX];
+  int parsed = 0;
+  while (parsed < COMMAND_STREAM_ARGUMENT_MAX) {
+    while (line < end && (*line == ' ' || *line == '\t' || *line == '\r')) line++;
+    if (line == end || *line < '0' || *line > '9') break;
+    int64_t value = 0;
+    while (line < end && *line >= '0' && *line <= '9') {
+      if (value <= COMMAND_STREAM_NUMBER_MAX) value = value * 10 + *line - '0';
+      line++;
+    }
+    arguments[parsed++] = value;
+  }
+  while (line < end && (*line == ' ' || *line == '\t' || *line == '\r')) line++;
+
+  if (argument_count < 0 || parsed != argument_count || line != end) {
+    command_stream->command_count++;
+    command_stream_write_reply(command_stream, COMMAND_STREAM_STATUS_ERROR);
+    return;
+  }
+  command_stream_run_command(command_stream, command, arguments);
+}
+
+
+/**
+ * Run every complete command in the input buffer.
+ */
+void command_stream_run_buffer(struct CommandStream* command_stream) {
+  char* input = command_stream->input;
+  int start = command_stream->input_start;
+  int end = command_stream->input_end;
+
+  if (command_stream->binary) {
+    while (start < end) {
+      enum CommandStreamCommand command = (unsigned char)input[start];
+      int argument_count = command_stream_get_argument_count(command);
+      if (argument_count < 0) {
+        command_stream->command_count++;
+        command_stream_write_reply(command_stream, COMMAND_STREAM_STATUS_ERROR);
+        start++;
+        continue;
+      }
+      int size = 1;
+      for (int i = 0; i < argument_count; i++) {
+        size += command_stream_get_argument_size(command, i);
+      }
+      if (end - start < size) break;
+      const unsigned char* record = (const unsigned char*)input + start + 1;
+      int64_t arguments[COMMAND_STREAM_ARGUMENT_MAX];
+      for (int i = 0; i < argument_count; i++) {
+        int argument_size = command_stream_get_argument_size(command, i);
+        arguments[i] = 0;
+        for (int byte = 0; byte < argument_size; byte++) {
+          arguments[i] |= (int64_t)record[byte] << (8 * byte);
+        }
+        record += argument_size;
+      }
+      command_stream_run_command(command_stream, command, arguments);
+      start += size;
+    }
+  } else {
+    while (start < end) {
+      char* line_end = memchr(input + start, '\n', end - start);
+      if (line_end == NULL) break;
+      command_stream_run_line(command_stream, input + start, line_end - (input + start));
+      start = line_end - input + 1;
+    }
+  }
+
+  command_stream->input_start = start;
+}
+
+
+/**
+ * Read the next batch of commands. Replies to the previous batch are sent
+ * first since the other end may wait for them before writing more.
+ */
+bool command_stream_fill(struct CommandStream* command_stream) {
+  command_stream_flush(command_stream);
+
+  int pending = command_stream->input_end - command_stream->input_start;
+  if (pending == COMMAND_STREAM_BUFFER_SIZE) {
+    log_error("Command stream: command longer than the input buffer, dropped.");
+    command_stream->command_count++;
+    command_stream_write_reply(command_stream, COMMAND_STREAM_STATUS_ERROR);
+    pending = 0;
+  }
+  memmove(
+      command_stream->input,
+      command_stream->input + command_stream->input_start,
+      pending
+  );
+  command_stream->input_start = 0;
+  command_stream->input_end = pending;
+
+  while (true) {
+    ssize_t result = read(
+        command_stream->input_fd,
+        command_stream->input + pending,
+        COMMAND_STREAM_BUFFER_SIZE - pending
+    );
+    if (result < 0) {
+      if (errno == EINTR) continue;
+      log_fatal_f("read() failed (%d): %s\n", errno, strerror(errno));
+    }
+    command_stream->input_end += result;
+    return result > 0;
+  }
+}
+
+
+void command_stream_run(struct CommandStream* command_stream) {
+  log_info_f("command_stream_run(binary=%s)", boolean_as_string(command_stream->binary));
+  while (command_stream_fill(command_stream)) {
+    command_stream_run_buffer(command_stream);
+  }
+
+  // The last text line may not end with a line feed.
+  int pending = command_stream->input_end - command_stream->input_start;
+  if (pending > 0) {
+    if (command_stream->binary) {
+      log_error_f("Command stream: %d bytes of truncated command ignored.", pending);
+    } else {
+      command_stream_run_line(
+          command_stream,
+          command_stream->input + command_stream->input_start,
+          pending
+      );
+    }
+  }
+  command_stream_flush(command_stream);
+  log_info_f("Command stream: %ld commands.", command_stream->command_count);
+}
@@ -0,0 +1,91 @@
+#ifndef COMMAND_STREAM_H
+#define COMMAND_STREAM_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "game_board.h"
+#include "session.h"
+
+
+#define COMMAND_STREAM_BUFFER_SIZE (64 * 1024)
+#define COMMAND_STREAM_ARGUMENT_MAX 4
+
+
+/**
+ * Drives the game board from a stream of commands, without any UI.
+ *
+ * Text commands, one per line:
+ *   reveal <x> <y>
+ *   flag <x> <y>
+ *   chord <x> <y>
+ *   new <width> <height> <density> <seed>
+ *   session <id>
+ *   end <id>
+ * Only the first letter of the command name is significant. Each command
+ * gets one line back: a status letter followed by the changed cells as
+ * "x,y,c", e.g. "p 3,4,. 3,5,1".
+ *
+ * Commands play the current session, 0 at first. `session` makes another
+ * one current, starting it if needed, and `end` frees one. Sessions are
+ * independent games, so one stream can host thousands of them.
+ *
+ * Binary commands are an opcode byte ('r', 'f', 'c', 'n', 's' or 'e')
+ * followed by one byte per argument, except the seed of 'n' which is 4
+ * bytes and session ids which are 2 bytes, little endian. Each command
+ * gets back the status byte, the number of changed cells on 2 bytes little
+ * endian, then 3 bytes per cell: x, y and c.
+ */
+enum CommandStreamStatus {
+  COMMAND_STREAM_STATUS_PLAYING = 'p',
+  COMMAND_STREAM_STATUS_WON = 'w',
+  COMMAND_STREAM_STATUS_LOST = 'l',
+  COMMAND_STREAM_STATUS_ERROR = 'e'
+};
+
+
+enum CommandStreamCommand {
+  COMMAND_STREAM_COMMAND_REVEAL = 'r',
+  COMMAND_STREAM_COMMAND_FLAG = 'f',
+  COMMAND_STREAM_COMMAND_CHORD = 'c',
+  COMMAND_STREAM_COMMAND_NEW = 'n',
+  COMMAND_STREAM_COMMAND_SESSION = 's',
+  COMMAND_STREAM_COMMAND_END = 'e'
+};
+
+
+struct CommandStream {
+  int input_fd;
+  int output_fd;
+  bool binary;
+  char input[COMMAND_STREAM_BUFFER_SIZE];
+  int input_start;
+  int input_end;
+  char output[COMMAND_STREAM_BUFFER_SIZE];
+  int output_size;
+  struct SessionTable sessions;
+  // Played by the commands. Its delta holds the cells changed by the last one.
+  struct Session* session;
+  long command_count;
+};
+
+
+void command_stream_init(
+    struct CommandStream* command_stream,
+    int input_fd,
+    int output_fd,
+    bool binary
+);
+void command_stream_close(struct CommandStream* command_stream);
+void command_stream_run(struct CommandStream* command_stream);
+enum CommandStreamStatus command_stream_execute(
+    struct CommandStream* command_stream,
+    enum CommandStreamCommand command,
+    const int64_t* arguments
+);
+enum CommandStreamStatus command_stream_get_status(struct GameBoard* game_board);
+char command_stream_get_glyph(struct GameBoard* game_board, int index);
+char* command_stream_format_int(char* output, int value);
+
+
+#endif
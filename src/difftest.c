@@ -0,0 +1,334 @@
+#include "difftest.h"
+
+
+/**
+ * The same board played by the optimized kernels and the reference ones.
+ * The previous visibility and markers are the reference board before the
+ * last move, to check which cells the delta should hold.
+ */
+struct Difftest {
+  struct GameBoard optimized;
+  struct GameBoard reference;
+  struct GameBoardDelta delta;
+  bool in_delta[GAME_BOARD_INDEX_MAX];
+  bool previous_visibility_map[GAME_BOARD_INDEX_MAX];
+  char previous_markers[GAME_BOARD_INDEX_MAX];
+  char report[DIFFTEST_REPORT_SIZE];
+};
+
+
+/**
+ * Boards shared by the difftest threads, handed out in batches from
+ * `next_board`. A divergence lowers `stop_board` so no board after it is
+ * started. Every board before the lowest divergence is still played, so
+ * the board reported does not depend on the thread count.
+ */
+struct DifftestPool {
+  unsigned int first_seed;
+  int board_count;
+  atomic_int next_board;
+  atomic_int stop_board;
+  atomic_long move_count;
+};
+
+
+struct DifftestWorker {
+  struct Difftest difftest;
+  struct DifftestPool* pool;
+  pthread_t thread;
+  // First divergent board of this thread, or `board_count`.
+  int divergent_board;
+};
+
+
+// The board sizes offered by the menu, tested as often as random sizes.
+const int g_difftest_board_sizes[][2] = {
+  {GAME_BOARD_EASY_WIDTH, GAME_BOARD_EASY_HEIGHT},
+  {GAME_BOARD_MEDIUM_WIDTH, GAME_BOARD_MEDIUM_HEIGHT},
+  {GAME_BOARD_HARD_WIDTH, GAME_BOARD_HARD_HEIGHT}
+};
+
+
+const char* g_difftest_command_names[] = {"play", "chord", "ok_marker", "mine_marker"};
+
+
+struct DifftestWorker g_difftest_workers[DIFFTEST_THREAD_MAX];
+
+
+const char* difftest_compare_targets(struct Difftest* difftest, int index) {
+  struct GameBoard* reference = &difftest->reference;
+  int x = game_board_get_column(reference, index);
+  int y = game_board_get_line(reference, index);
+  for (int target = 0; target < GAME_BOARD_TARGET_MAX; target++) {
+    bool is_target = (difftest->optimized.targets[target][y] >> x) & 1;
+    if (is_target != game_board_reference_is_target(reference, target, x, y)) {
+      return target == GAME_BOARD_TARGET_FRONTIER ? "frontier" : "unsatisfied";
+    }
+  }
+  return NULL;
+}
+
+
+/**
+ * Report where the two boards first differ, or return NULL.
+ * Targets can only change around a changed cell, so the other cells are
+ * only checked when `all_targets` is set.
+ */
+const char* difftest_compare(
+    struct Difftest* difftest,
+    bool all_targets,
+    int* divergent_index
+) {
+  struct GameBoard* optimized = &difftest->optimized;
+  struct GameBoard* reference = &difftest->reference;
+  int cell_count = game_board_get_cell_count(reference);
+
+  for (int cell_i = 0; cell_i < cell_count; cell_i++) {
+    int i = game_board_get_index(reference, cell_i % reference->width, cell_i / reference->width);
+    *divergent_index = i;
+    if (optimized->board[i] != reference->board[i]) return "board";
+    if (optimized->visibility_map[i] != reference->visibility_map[i]) return "visibility";
+    if (optimized->markers[i] != reference->markers[i]) return "marker";
+
+    // Every cell that changed, and only those, is in the delta.
+    bool changed = reference->visibility_map[i] != difftest->previous_visibility_map[i]
+      || reference->markers[i] != difftest->previous_markers[i];
+    if (!difftest->delta.overflow && changed != difftest->in_delta[i]) return "delta";
+
+    if (all_targets) {
+      const char* divergence = difftest_compare_targets(difftest, i);
+      if (divergence != NULL) return divergence;
+    } else if (changed) {
+      int neighbours[GAME_BOARD_NEIGHBOUR_MAX + 1];
+      int count = game_board_get_neighbours(reference, i, neighbours);
+      neighbours[count++] = i;
+      for (int j = 0; j < count; j++) {
+        *divergent_index = neighbours[j];
+        const char* divergence = difftest_compare_targets(difftest, neighbours[j]);
+        if (divergence != NULL) return divergence;
+      }
+    }
+  }
+
+  *divergent_index = game_board_get_index(reference, 0, 0);
+  // The score only changes with the board, checked after setup.
+  if (all_targets && optimized->bbbv != game_board_reference_count_3bv(reference)) return "3bv";
+  if (game_board_is_win(optimized) != game_board_reference_is_win(reference)) return "win";
+  if (game_board_is_lost(optimized) != game_board_reference_is_lost(reference)) return "lost";
+  return NULL;
+}
+
+
+void difftest_play(struct Difftest* difftest, int command, int x, int y) {
+  struct GameBoard* optimized = &difftest->optimized;
+  struct GameBoard* reference = &difftest->reference;
+  struct GameBoardDelta* delta = &difftest->delta;
+
+  // Whole rows, border included, are cheaper to copy than to skip.
+  int index_end = game_board_get_index(reference, 0, reference->height);
+  for (int i = 0; i < index_end; i++) {
+    difftest->previous_visibility_map[i] = reference->visibility_map[i];
+    difftest->previous_markers[i] = reference->markers[i];
+  }
+  game_board_delta_clear(delta);
+  switch (command) {
+    case 0:
+      game_board_play_cell(optimized, x, y, delta);
+      game_board_reference_play_cell(reference, x, y);
+      break;
+    case 1:
+      game_board_chord(optimized, x, y, delta);
+      game_board_reference_chord(reference, x, y);
+      break;
+    case 2:
+      game_board_switch_ok_marker(optimized, x, y, delta);
+      game_board_reference_switch_ok_marker(reference, x, y);
+      break;
+    case 3:
+      game_board_switch_mine_marker(optimized, x, y, delta);
+      game_board_reference_switch_mine_marker(reference, x, y);
+      break;
+  }
+
+  for (int i = 0; i < index_end; i++) {
+    difftest->in_delta[i] = false;
+  }
+  for (int i = 0; i < delta->count; i++) {
+    difftest->in_delta[delta->cells[i]] = true;
+  }
+}
+
+
+void difftest_report(
+    struct Difftest* difftest,
+    unsigned int seed,
+    int density,
+    const char* move,
+    const char* divergence,
+    int divergent_index
+) {
+  struct GameBoard* reference = &difftest->reference;
+  snprintf(
+      difftest->report,
+      sizeof(difftest->report),
+      "difftest: seed=%u size=%dx%d density=%d %s: %s differs at (%d, %d)\n",
+      seed,
+      reference->width,
+      reference->height,
+      density,
+      move,
+      divergence,
+      game_board_get_column(reference, divergent_index),
+      game_board_get_line(reference, divergent_index)
+  );
+}
+
+
+/**
+ * Set up one board from its seed on both sides and play random moves until
+ * the game ends. The seed alone decides the size, density and moves, so a
+ * divergence is replayed with `--difftest 1 <seed>`.
+ */
+bool difftest_run_board(struct Difftest* difftest, unsigned int seed, long* move_count) {
+  unsigned int state = seed;
+  int width;
+  int height;
+  if (rand_r(&state) % 2 == 0) {
+    int size = rand_r(&state) % array_size(g_difftest_board_sizes);
+    width = g_difftest_board_sizes[size][0];
+    height = g_difftest_board_sizes[size][1];
+  } else {
+    width = 1 + rand_r(&state) % GAME_BOARD_WIDTH_MAX;
+    height = 1 + rand_r(&state) % GAME_BOARD_HEIGHT_MAX;
+  }
+  int density = rand_r(&state) % (DIFFTEST_DENSITY_MAX + 1);
+
+  game_board_init(&difftest->optimized, width, height);
+  game_board_init(&difftest->reference, width, height);
+  game_board_delta_invalidate(&difftest->delta);
+  game_board_setup_game(&difftest->optimized, density, seed);
+  game_board_reference_setup_game(&difftest->reference, density, seed);
+
+  int divergent_index;
+  const char* divergence = difftest_compare(difftest, true, &divergent_index);
+  if (divergence != NULL) {
+    difftest_report(difftest, seed, density, "setup", divergence, divergent_index);
+    return false;
+  }
+
+  for (int move = 0; move < DIFFTEST_MOVES_MAX; move++) {
+    if (game_board_reference_is_win(&difftest->reference)) break;
+    if (game_board_reference_is_lost(&difftest->reference)) break;
+
+    int choice = rand_r(&state) % 10;
+    int command = choice < 5 ? 0 : choice < 7 ? 1 : choice < 8 ? 2 : 3;
+    int x = rand_r(&state) % width;
+    int y = rand_r(&state) % height;
+    difftest_play(difftest, command, x, y);
+    (*move_count)++;
+    divergence = difftest_compare(difftest, false, &divergent_index);
+    if (divergence != NULL) {
+      char description[64];
+      snprintf(
+          description,
+          sizeof(description),
+          "move=%d %s(%d, %d)",
+          move,
+          g_difftest_command_names[command],
+          x,
+          y
+      );
+      difftest_report(difftest, seed, density, description, divergence, divergent_index);
+      return false;
+    }
+  }
+
+  divergence = difftest_compare(difftest, true, &divergent_index);
+  if (divergence != NULL) {
+    difftest_report(difftest, seed, density, "end", divergence, divergent_index);
+    return false;
+  }
+  return true;
+}
+
+
+void* difftest_worker_run(void* argument) {
+  struct DifftestWorker* worker = argument;
+  struct DifftestPool* pool = worker->pool;
+  long move_count = 0;
+  worker->divergent_board = pool->board_count;
+
+  // Batches are taken in increasing order, so the first divergence of a
+  // thread is its lowest one.
+  while (worker->divergent_board == pool->board_count) {
+    int board = atomic_fetch_add(&pool->next_board, DIFFTEST_BATCH_BOARDS);
+    int end = imin(board + DIFFTEST_BATCH_BOARDS, pool->board_count);
+    if (board >= end) break;
+    for (; board < end; board++) {
+      if (board >= atomic_load(&pool->stop_board)) break;
+      if (difftest_run_board(&worker->difftest, pool->first_seed + board, &move_count)) continue;
+      worker->divergent_board = board;
+      int stop_board = atomic_load(&pool->stop_board);
+      while (board < stop_board && !atomic_compare_exchange_weak(&pool->stop_board, &stop_board, board));
+      break;
+    }
+  }
+  atomic_fetch_add(&pool->move_count, move_count);
+  // Trace buffers are per thread and only the main one is flushed at exit.
+  trace_flush();
+  return NULL;
+}
+
+
+/**
+ * Play `board_count` seeded boards on the optimized and reference kernels,
+ * from `first_seed`, and stop at the first divergence. Boards are spread
+ * over `thread_count` threads, one per core when it is not positive. Each
+ * board only depends on its seed, so the output is the same whatever the
+ * thread count.
+ */
+bool difftest_run(int board_count, unsigned int first_seed, int thread_count) {
+  if (thread_count <= 0) thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+  if (thread_count < 1) thread_count = 1;
+  if (thread_count > DIFFTEST_THREAD_MAX) thread_count = DIFFTEST_THREAD_MAX;
+
+  struct DifftestPool pool;
+  pool.first_seed = first_seed;
+  pool.board_count = board_count;
+  atomic_init(&pool.next_board, 0);
+  atomic_init(&pool.stop_board, board_count);
+  atomic_init(&pool.move_count, 0);
+
+  for (int thread_i = 0; thread_i < thread_count; thread_i++) {
+    struct DifftestWorker* worker = &g_difftest_workers[thread_i];
+    worker->pool = &pool;
+    int error = pthread_create(&worker->thread, NULL, difftest_worker_run, worker);
+    if (error != 0) {
+      log_fatal_f("pthread_create() failed (%d): %s\n", error, strerror(error));
+    }
+  }
+
+  struct DifftestWorker* divergent_worker = NULL;
+  for (int thread_i = 0; thread_i < thread_count; thread_i++) {
+    struct DifftestWorker* worker = &g_difftest_workers[thread_i];
+    pthread_join(worker->thread, NULL);
+    if (worker->divergent_board == board_count) continue;
+    if (divergent_worker == NULL || worker->divergent_board < divergent_worker->divergent_board) {
+      divergent_worker = worker;
+    }
+  }
+
+  if (divergent_worker != NULL) {
+    fputs(divergent_worker->difftest.report, stdout);
+    return false;
+  }
+  printf(
+      "difftest: boards=%d moves=%ld seeds=%u..%u threads=%d ok\n",
+      board_count,
+      atomic_load(&pool.move_count),
+      first_seed,
+      first_seed + board_count - 1,
+      thread_count
+  );
+  return true;
+}
@@ -0,0 +1,27 @@
+#ifndef DIFFTEST_H
+#define DIFFTEST_H
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "game_board.h"
+#include "game_board_reference.h"
+#include "trace.h"
+
+
+#define DIFFTEST_BOARDS 100000
+#define DIFFTEST_MOVES_MAX 400
+#define DIFFTEST_DENSITY_MAX 40
+#define DIFFTEST_THREAD_MAX 64
+// Boards a thread takes at once from the shared counter.
+#define DIFFTEST_BATCH_BOARDS 64
+#define DIFFTEST_REPORT_SIZE 256
+
+
+bool difftest_run(int board_count, unsigned int first_seed, int thread_count);
+
+
+#endif
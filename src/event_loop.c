@@ -0,0 +1,99 @@
+#include "event_loop.h"
+
+
+/**
+ * Must be called before the render backend installs its signal handlers.
+ * The handled signals are blocked and only delivered through the loop.
+ */
+void event_loop_init(struct EventLoop* event_loop) {
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGWINCH);
+  sigaddset(&signals, SIGTERM);
+  sigaddset(&signals, SIGINT);
+  if (sigprocmask(SIG_BLOCK, &signals, NULL) == -1) {
+    log_fatal_f("sigprocmask() failed (%d): %s\n", errno, strerror(errno));
+  }
+
+  event_loop->signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (event_loop->signal_fd == -1) {
+    log_fatal_f("signalfd() failed (%d): %s\n", errno, strerror(errno));
+  }
+
+  event_loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (event_loop->timer_fd == -1) {
+    log_fatal_f("timerfd_create() failed (%d): %s\n", errno, strerror(errno));
+  }
+
+  event_loop->fds[EVENT_LOOP_SOURCE_INPUT].fd = STDIN_FILENO;
+  event_loop->fds[EVENT_LOOP_SOURCE_TIMER].fd = event_loop->timer_fd;
+  event_loop->fds[EVENT_LOOP_SOURCE_SIGNAL].fd = event_loop->signal_fd;
+  // Optional sources are ignored by poll until they are watched.
+  event_loop->fds[EVENT_LOOP_SOURCE_SPECTATOR].fd = -1;
+  for (int i = 0; i < EVENT_LOOP_SOURCE_MAX; i++) {
+    event_loop->fds[i].events = POLLIN;
+  }
+}
+
+
+/**
+ * Arm the timer to fire once in `timeout_ms`, or disarm it when negative.
+ */
+void event_loop_set_timer(struct EventLoop* event_loop, int timeout_ms) {
+  struct itimerspec timer;
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_nsec = 0;
+  timer.it_value.tv_sec = 0;
+  timer.it_value.tv_nsec = 0;
+  if (timeout_ms >= 0) {
+    timer.it_value.tv_sec = timeout_ms / 1000;
+    // A zero value would disarm the timer.
+    timer.it_value.tv_nsec = imax(1, (timeout_ms % 1000) * 1000000);
+  }
+  timerfd_settime(event_loop->timer_fd, 0, &timer, NULL);
+}
+
+
+void event_loop_watch(struct EventLoop* event_loop, enum EventLoopSource source, int fd) {
+  event_loop->fds[source].fd = fd;
+}
+
+
+/**
+ * Sleep until at least one source is ready and return their bits.
+ */
+int event_loop_wait(struct EventLoop* event_loop) {
+  while (poll(event_loop->fds, EVENT_LOOP_SOURCE_MAX, -1) == -1) {
+    if (errno != EINTR) {
+      log_fatal_f("poll() failed (%d): %s\n", errno, strerror(errno));
+    }
+  }
+
+  int events = 0;
+  for (int i = 0; i < EVENT_LOOP_SOURCE_MAX; i++) {
+    if (event_loop->fds[i].revents != 0) events |= 1 << i;
+  }
+
+  if (events & EVENT_LOOP_TIMER) {
+    uint64_t expirations;
+    read(event_loop->timer_fd, &expirations, sizeof(expirations));
+  }
+  return events;
+}
+
+
+/**
+ * Return the next pending signal, 0 when there is none.
+ */
+int event_loop_read_signal(struct EventLoop* event_loop) {
+  struct signalfd_siginfo info;
+  if (read(event_loop->signal_fd, &info, sizeof(info)) != sizeof(info)) return 0;
+  log_info_f("Signal received: %d", info.ssi_signo);
+  return info.ssi_signo;
+}
+
+
+void event_loop_close(struct EventLoop* event_loop) {
+  close(event_loop->timer_fd);
+  close(event_loop->signal_fd);
+}
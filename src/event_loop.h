@@ -0,0 +1,52 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include "log.h"
+#include "util.h"
+
+
+enum EventLoopSource {
+  EVENT_LOOP_SOURCE_INPUT,
+  EVENT_LOOP_SOURCE_TIMER,
+  EVENT_LOOP_SOURCE_SIGNAL,
+  EVENT_LOOP_SOURCE_SPECTATOR,
+  EVENT_LOOP_SOURCE_MAX
+};
+
+
+// Bits returned by `event_loop_wait`.
+#define EVENT_LOOP_INPUT (1 << EVENT_LOOP_SOURCE_INPUT)
+#define EVENT_LOOP_TIMER (1 << EVENT_LOOP_SOURCE_TIMER)
+#define EVENT_LOOP_SIGNAL (1 << EVENT_LOOP_SOURCE_SIGNAL)
+#define EVENT_LOOP_SPECTATOR (1 << EVENT_LOOP_SOURCE_SPECTATOR)
+
+
+/**
+ * Waits on stdin, a timer, the signals the game handles and the optional
+ * spectator socket. The process sleeps in `poll` until one of them is
+ * ready, the timer is only armed while something has to happen on a clock.
+ */
+struct EventLoop {
+  struct pollfd fds[EVENT_LOOP_SOURCE_MAX];
+  int timer_fd;
+  int signal_fd;
+};
+
+
+void event_loop_init(struct EventLoop* event_loop);
+void event_loop_set_timer(struct EventLoop* event_loop, int timeout_ms);
+void event_loop_watch(struct EventLoop* event_loop, enum EventLoopSource source, int fd);
+int event_loop_wait(struct EventLoop* event_loop);
+int event_loop_read_signal(struct EventLoop* event_loop);
+void event_loop_close(struct EventLoop* event_loop);
+
+
+#endif
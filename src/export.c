@@ -0,0 +1,228 @@
+#include "export.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+
+struct Export g_export;
+
+
+void export_init(struct Export* export, int fd, bool binary, int width_max) {
+  export->fd = fd;
+  export->binary = binary;
+  export->buffer_size = 0;
+  export->byte_count = 0;
+  export->mine_count = 0;
+  export->width_max = width_max;
+  int row_size = width_max + 2;
+  arena_init(&export->arena, 4 * (size_t)row_size + width_max + 64);
+  for (int i = 0; i < 3; i++) {
+    export->rows[i] = arena_allocate(&export->arena, row_size, 1);
+  }
+  export->column_sums = arena_allocate(&export->arena, row_size, 1);
+  export->line = arena_allocate(&export->arena, width_max + 1, 1);
+}
+
+
+void export_flush(struct Export* export) {
+  int written = 0;
+  while (written < export->buffer_size) {
+    ssize_t result = write(export->fd, export->buffer + written, export->buffer_size - written);
+    if (result < 0) {
+      if (errno == EINTR) continue;
+      log_fatal_f("write() failed (%d): %s\n", errno, strerror(errno));
+    }
+    written += result;
+  }
+  export->buffer_size = 0;
+}
+
+
+void export_close(struct Export* export) {
+  export_flush(export);
+  arena_close(&export->arena);
+}
+
+
+/**
+ * Copy into the buffer, which is only written when full.
+ */
+void export_write(struct Export* export, const void* data, int size) {
+  const char* input = data;
+  export->byte_count += size;
+  while (size > 0) {
+    if (export->buffer_size == EXPORT_BUFFER_SIZE) export_flush(export);
+    int chunk = imin(size, EXPORT_BUFFER_SIZE - export->buffer_size);
+    memcpy(export->buffer + export->buffer_size, input, chunk);
+    export->buffer_size += chunk;
+    input += chunk;
+    size -= chunk;
+  }
+}
+
+
+void export_write_uint32(struct Export* export, uint32_t value) {
+  uint8_t bytes[4] = {value, value >> 8, value >> 16, value >> 24};
+  export_write(export, bytes, sizeof(bytes));
+}
+
+
+/**
+ * Draw the mines of one row, leaving the ghost cells empty.
+ */
+void export_generate_row(
+    struct Export* export,
+    uint8_t* row,
+    int width,
+    int density,
+    struct GameBoardRandom* random
+) {
+  int mine_count = 0;
+  for (int x = 1; x <= width; x++) {
+    row[x] = game_board_random_next(random) % 100 < density;
+    mine_count += row[x];
+  }
+  export->mine_count += mine_count;
+}
+
+
+void export_write_text_row(
+    struct Export* export,
+    const uint8_t* above,
+    const uint8_t* row,
+    const uint8_t* below,
+    int width
+) {
+  // Mines of each column of the 3 rows, so a count is 3 additions.
+  uint8_t* column_sums = export->column_sums;
+  for (int x = 0; x <= width + 1; x++) {
+    column_sums[x] = above[x] + row[x] + below[x];
+  }
+  char* line = export->line;
+  for (int x = 1; x <= width; x++) {
+    int count = column_sums[x - 1] + column_sums[x] + column_sums[x + 1];
+    char glyph = count == 0 ? EXPORT_GLYPH_EMPTY : '0' + count;
+    line[x - 1] = row[x] ? EXPORT_GLYPH_MINE : glyph;
+  }
+  line[width] = '\n';
+  export_write(export, line, width + 1);
+}
+
+
+void export_write_binary_row(struct Export* export, const uint8_t* row, int width) {
+  char* line = export->line;
+  int size = (width + 7) / 8;
+  memset(line, 0, size);
+  for (int x = 0; x < width; x++) {
+    line[x / 8] |= row[x + 1] << (x % 8);
+  }
+  export_write(export, line, size);
+}
+
+
+/**
+ * Generate the puzzle of `seed` and write it one row at a time. Row y is
+ * written once row y + 1 is drawn, so memory does not grow with `height`.
+ */
+void export_puzzle(
+    struct Export* export,
+    int width,
+    long height,
+    int density,
+    unsigned int seed
+) {
+  if (export->binary) {
+    export_write_uint32(export, width);
+    export_write_uint32(export, height);
+    export_write_uint32(export, density);
+    export_write_uint32(export, seed);
+  } else {
+    char header[64];
+    int size = snprintf(header, sizeof(header), "%d %ld %d %u\n", width, height, density, seed);
+    export_write(export, header, size);
+  }
+
+  struct GameBoardRandom random;
+  game_board_random_init(&random, seed);
+  uint8_t* above = export->rows[0];
+  uint8_t* row = export->rows[1];
+  uint8_t* below = export->rows[2];
+  memset(above, 0, width + 2);
+  memset(row, 0, width + 2);
+  memset(below, 0, width + 2);
+  if (height > 0) export_generate_row(export, row, width, density, &random);
+
+  for (long y = 0; y < height; y++) {
+    if (y + 1 < height) {
+      export_generate_row(export, below, width, density, &random);
+    } else {
+      memset(below, 0, width + 2);
+    }
+    if (export->binary) {
+      export_write_binary_row(export, row, width);
+    } else {
+      export_write_text_row(export, above, row, below, width);
+    }
+    uint8_t* next_below = above;
+    above = row;
+    row = below;
+    below = next_below;
+  }
+  if (!export->binary) export_write(export, "\n", 1);
+}
+
+
+/**
+ * Write `puzzle_count` puzzles from `first_seed` to `path`, or to the
+ * standard output for "-".
+ */
+bool export_run(
+    const char* path,
+    bool binary,
+    int width,
+    long height,
+    int puzzle_count,
+    unsigned int first_seed,
+    int density
+) {
+  if (
+      width <= 0
+      || width > EXPORT_WIDTH_MAX
+      || height <= 0
+      || height > UINT32_MAX
+      || density < 0
+      || density > 100
+  ) {
+    fprintf(stderr, "export: invalid size %dx%ld or density %d\n", width, height, density);
+    return false;
+  }
+  int fd = STDOUT_FILENO;
+  if (strcmp(path, "-") != 0) {
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+      log_error_f("open(\"%s\") failed (%d): %s", path, errno, strerror(errno));
+      fprintf(stderr, "export: cannot open %s: %s\n", path, strerror(errno));
+      return false;
+    }
+  }
+
+  struct Export* export = &g_export;
+  export_init(export, fd, binary, width);
+  if (binary) export_write(export, EXPORT_MAGIC, strlen(EXPORT_MAGIC));
+  for (int puzzle = 0; puzzle < puzzle_count; puzzle++) {
+    export_puzzle(export, width, height, density, first_seed + puzzle);
+  }
+  export_close(export);
+  if (fd != STDOUT_FILENO && close(fd) == -1) {
+    log_fatal_f("close() failed (%d): %s\n", errno, strerror(errno));
+  }
+  fprintf(
+      stderr,
+      "export: puzzles=%d size=%dx%ld mines=%ld bytes=%ld\n",
+      puzzle_count,
+      width,
+      height,
+      export->mine_count,
+      export->byte_count
+  );
+  return true;
+}
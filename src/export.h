@@ -0,0 +1,70 @@
+#ifndef EXPORT_H
+#define EXPORT_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "arena.h"
+#include "game_board.h"
+
+
+#define EXPORT_BUFFER_SIZE (1024 * 1024)
+// Widest row. The row buffers of 5 bytes per cell stay under INT_MAX.
+#define EXPORT_WIDTH_MAX (256 * 1024 * 1024)
+#define EXPORT_DENSITY 10
+#define EXPORT_MAGIC "MSPUZZL1"
+#define EXPORT_GLYPH_EMPTY '.'
+#define EXPORT_GLYPH_MINE '*'
+
+
+/**
+ * Writes seeded puzzles to a file, for test corpora and the simulator.
+ * Each cell is a mine with a probability of `density` percent, drawn from
+ * the stream of the puzzle seed. Boards are generated row by row and only
+ * 3 rows are kept, so a board can be as tall as wanted.
+ *
+ * Text puzzles are a "<width> <height> <density> <seed>" line, then one
+ * line per row: '*' for a mine, '.' for an empty cell, or the number of
+ * neighbour mines. A blank line follows each puzzle.
+ *
+ * Binary files start with "MSPUZZL1". Each puzzle is the width, height,
+ * density and seed on 4 bytes each, little endian, then the rows with one
+ * bit per cell, bit x % 8 of byte x / 8 set for a mine.
+ */
+struct Export {
+  int fd;
+  bool binary;
+  char buffer[EXPORT_BUFFER_SIZE];
+  int buffer_size;
+  // 3 rows of mines, with a ghost cell at both ends, and a formatted row.
+  struct Arena arena;
+  int width_max;
+  uint8_t* rows[3];
+  uint8_t* column_sums;
+  char* line;
+  long byte_count;
+  long mine_count;
+};
+
+
+void export_init(struct Export* export, int fd, bool binary, int width_max);
+void export_close(struct Export* export);
+void export_puzzle(
+    struct Export* export,
+    int width,
+    long height,
+    int density,
+    unsigned int seed
+);
+bool export_run(
+    const char* path,
+    bool binary,
+    int width,
+    long height,
+    int puzzle_count,
+    unsigned int first_seed,
+    int density
+);
+
+
+#endif
@@ -1,6 +1,16 @@
 #include "game.h"
 
 #define BOMB_POURCENTAGE 10
+// Boards are drawn again until their 3BV falls in the band of their
+// difficulty: the middle 80% of 100k boards of each size.
+#define GAME_EASY_BBBV_MIN 4
+#define GAME_EASY_BBBV_MAX 12
+#define GAME_MEDIUM_BBBV_MIN 19
+#define GAME_MEDIUM_BBBV_MAX 36
+#define GAME_HARD_BBBV_MIN 68
+#define GAME_HARD_BBBV_MAX 98
+// Keeps the last board drawn if the band is never hit.
+#define GAME_SETUP_ATTEMPT_MAX 64
 
 
 const char* g_game_state_strings[] = {
@@ -10,6 +20,7 @@ const char* g_game_state_strings[] = {
   "GAME_STATE_GAME_WON",
   "GAME_STATE_MENU",
   "GAME_STATE_MANUAL",
+  "GAME_STATE_STATS",
   "GAME_STATE_QUIT",
   "GAME_STATE_MAX"
 };
@@ -19,32 +30,52 @@ void game_init(struct Game* game, int width, int height) {
   log_info_f("game_init(game, %d, %d)", width, height);
   game->cursor.x = 0;
   game->cursor.y = 0;
+  game->motion_count = 0;
+  game->start_ms = 0;
+  game->click_count = 0;
   game_board_init(&game->game_board, width, height);
+  game_board_delta_invalidate(&game->delta);
   game->game_state = GAME_STATE_START_MENU;
 }
 
 
-void game_init_easy_mode(struct Game* game) {
-  int width = 9;
-  int height = 5;
+/**
+ * Each board gets its own seed so a recorded session can generate it again.
+ * Boards whose 3BV is outside [bbbv_min, bbbv_max] are rejected, so games
+ * of one difficulty take a similar effort.
+ */
+void game_setup(struct Game* game, int width, int height, int bbbv_min, int bbbv_max) {
   game_init(game, width, height);
-  game_board_setup_game(&game->game_board, BOMB_POURCENTAGE);
+  game->density = BOMB_POURCENTAGE;
+  for (int attempt = 0; attempt < GAME_SETUP_ATTEMPT_MAX; attempt++) {
+    if (attempt > 0) game_board_init(&game->game_board, width, height);
+    game->seed = rand();
+    game_board_setup_game(&game->game_board, game->density, game->seed);
+    int bbbv = game->game_board.bbbv;
+    if (bbbv >= bbbv_min && bbbv <= bbbv_max) break;
+  }
+  log_info_f("Board 3BV: %d", game->game_board.bbbv);
+}
+
+
+void game_init_easy_mode(struct Game* game) {
+  int width = GAME_BOARD_EASY_WIDTH;
+  int height = GAME_BOARD_EASY_HEIGHT;
+  game_setup(game, width, height, GAME_EASY_BBBV_MIN, GAME_EASY_BBBV_MAX);
 }
 
 
 void game_init_medium_mode(struct Game* game) {
-  int width = 17;
-  int height = 9;
-  game_init(game, width, height);
-  game_board_setup_game(&game->game_board, BOMB_POURCENTAGE);
+  int width = GAME_BOARD_MEDIUM_WIDTH;
+  int height = GAME_BOARD_MEDIUM_HEIGHT;
+  game_setup(game, width, height, GAME_MEDIUM_BBBV_MIN, GAME_MEDIUM_BBBV_MAX);
 }
 
 
 void game_init_hard_mode(struct Game* game) {
-  int width = 31;
-  int height = 15;
-  game_init(game, width, height);
-  game_board_setup_game(&game->game_board, BOMB_POURCENTAGE);
+  int width = GAME_BOARD_HARD_WIDTH;
+  int height = GAME_BOARD_HARD_HEIGHT;
+  game_setup(game, width, height, GAME_HARD_BBBV_MIN, GAME_HARD_BBBV_MAX);
 }
 
 
@@ -13,6 +13,7 @@ enum GameState {
   GAME_STATE_GAME_WON,
   GAME_STATE_MENU,
   GAME_STATE_MANUAL,
+  GAME_STATE_STATS,
   GAME_STATE_QUIT,
   GAME_STATE_MAX
 };
@@ -22,6 +23,17 @@ struct Game {
   struct GameBoard game_board;
   struct Cursor cursor; 
   enum GameState game_state;
+  // Board changes not drawn yet, consumed by each full frame.
+  struct GameBoardDelta delta;
+  // Inputs of `game_board_setup_game`, enough to generate the board again.
+  unsigned int seed;
+  int density;
+  // Pending count prefix typed before a motion, 0 when none.
+  int motion_count;
+  // Time of the first reveal, 0 until then.
+  long start_ms;
+  // Reveals, chords and markers played on this board.
+  int click_count;
 };
 
 
@@ -1,6 +1,40 @@
 #include "game_board.h"
 
 
+_Static_assert(
+    GAME_BOARD_WIDTH_MAX <= 64,
+    "A board row must fit in one target bitset word."
+);
+
+
+// The 8 neighbours of a cell, row by row.
+const int g_game_board_neighbour_offsets[GAME_BOARD_NEIGHBOUR_MAX] = {
+  -GAME_BOARD_STRIDE - 1,
+  -GAME_BOARD_STRIDE,
+  -GAME_BOARD_STRIDE + 1,
+  -1,
+  1,
+  GAME_BOARD_STRIDE - 1,
+  GAME_BOARD_STRIDE,
+  GAME_BOARD_STRIDE + 1
+};
+
+
+void game_board_clear_targets(struct GameBoard* game_board);
+void game_board_reset_targets(struct GameBoard* game_board);
+void game_board_clear_cells_kernel(struct GameBoard* game_board, int width, int height);
+void game_board_generate_kernel(
+    struct GameBoard* game_board,
+    int pourcentage,
+    struct GameBoardRandom* random,
+    int width,
+    int height
+);
+void game_board_index_openings_kernel(struct GameBoard* game_board, int width, int height);
+int game_board_count_3bv_kernel(struct GameBoard* game_board, int width, int height);
+const struct GameBoardKernels* game_board_select_kernels(int width, int height);
+
+
 void game_board_init(struct GameBoard* game_board, int width, int height) {
   if (width > GAME_BOARD_WIDTH_MAX) {
     log_fatal_f("width is bigger than the allowed max. width=%d", width);
@@ -12,21 +46,54 @@ void game_board_init(struct GameBoard* game_board, int width, int height) {
 
   game_board->width = width;
   game_board->height = height;
-  for (int i = 0; i < width * height; i++) {
-    game_board->board[i] = BOARD_CELL_TYPE_EMPTY;
-    game_board->visibility_map[i] = false;
-    game_board->markers[i] = BOARD_CELL_TYPE_EMPTY;
+  game_board->kernels = game_board_select_kernels(width, height);
+  game_board->kernels->clear_cells(game_board);
+  game_board->mine_count = 0;
+  game_board->revealed_count = 0;
+  game_board->revealed_mine_count = 0;
+  game_board->bbbv = 0;
+  // Nothing is revealed yet so no cell is a target.
+  game_board_clear_targets(game_board);
+  // Until mines are set, the whole board is one opening with a span per row.
+  for (int y = 0; y < height; y++) {
+    game_board->opening_spans[y] = (struct GameBoardSpan){y, 0, width};
+  }
+  game_board->opening_first_spans[0] = 0;
+  game_board->opening_first_spans[1] = height;
+  game_board->opening_count = width * height > 0 ? 1 : 0;
+}
+
+
+void game_board_delta_clear(struct GameBoardDelta* delta) {
+  delta->count = 0;
+  delta->overflow = false;
+}
+
+
+void game_board_delta_invalidate(struct GameBoardDelta* delta) {
+  if (delta == NULL) return;
+  delta->overflow = true;
+}
+
+
+// Callers that do not care about the delta pass NULL.
+void game_board_delta_record(struct GameBoardDelta* delta, int index) {
+  if (delta == NULL) return;
+  if (delta->count >= GAME_BOARD_SIZE_MAX) {
+    delta->overflow = true;
+    return;
   }
+  delta->cells[delta->count++] = index;
 }
 
 
-int game_board_max_index(struct GameBoard* game_board) {
+int game_board_get_cell_count(struct GameBoard* game_board) {
   return game_board->width * game_board->height;
 }
 
 
 int game_board_get_index(struct GameBoard* game_board, int x, int y) {
-  return y * game_board->width + x;
+  return (y + 1) * GAME_BOARD_STRIDE + x + 1;
 }
 
 
@@ -40,104 +107,345 @@ void game_board_show_cell(struct GameBoard* game_board, int x, int y) {
 }
 
 
+// The stride is a constant, so these compile to multiplications.
 int game_board_get_line(struct GameBoard* game_board, int index) {
-  return index / game_board->width;
+  return index / GAME_BOARD_STRIDE - 1;
 }
 
 
 int game_board_get_column(struct GameBoard* game_board, int index) {
-  return index % game_board->width;
+  return index % GAME_BOARD_STRIDE - 1;
 }
 
 
-void game_board_setup_game(struct GameBoard* game_board, int pourcentage) {
-  log_info_f("game_board_setup_game(game_board, %d)", pourcentage);
-  int width = game_board->width;
-  int height = game_board->height;
-  int cell_count = game_board->width * game_board->height;
-  char* board = game_board->board;
-  int bomb_count = (int)(cell_count * pourcentage / 100);
+/**
+ * Each setup draws from its own generator seeded with `seed`, so boards can
+ * be set up on several threads and still only depend on their seed.
+ */
+void game_board_setup_game(struct GameBoard* game_board, int pourcentage, unsigned int seed) {
+  log_info_f("game_board_setup_game(game_board, %d, %u)", pourcentage, seed);
+  trace_begin(TRACE_NAME_SETUP_GAME);
+  struct GameBoardRandom random;
+  game_board_random_init(&random, seed);
+  game_board->kernels->generate(game_board, pourcentage, &random);
+  trace_end(TRACE_NAME_SETUP_GAME);
+}
 
-  // Set random mines
-  for (int i = 0; i < bomb_count; i++) {
-    int x = rand() % width;
-    int y = rand() % height;
-    board[game_board_get_index(game_board, x, y)] = BOARD_CELL_TYPE_MINE;
-  }
-
-  // Set mine counters.
-  int offsets[] = {
-    -1,
-    width - 1,
-    -width - 1,
-    1,
-    width + 1,
-    -width + 1,
-    width,
-    -width
-  };
-  for (int board_i = 0; board_i < cell_count && board_i < GAME_BOARD_SIZE_MAX; board_i++) {
-    if (board[board_i] != BOARD_CELL_TYPE_MINE) continue;
-    for (int offset_i = 0; offset_i < array_size(offsets); offset_i++) {
-      int j = board_i + offsets[offset_i];
-      if (j < 0 || j >= cell_count) continue;
-      if (offset_i <= 2
-          && (game_board_get_column(game_board, j) != game_board_get_column(game_board, board_i) - 1)
-      ) continue;
-      if (offset_i > 2
-          && offset_i <= 5
-          && game_board_get_column(game_board, j) != game_board_get_column(game_board, board_i) + 1
-      ) continue;
-      if (board[j] == BOARD_CELL_TYPE_MINE) continue;
-      if (board[j] == BOARD_CELL_TYPE_EMPTY) {
-        board[j] = 1;
-      } else {
-        board[j]++;
+
+void game_board_random_init(struct GameBoardRandom* random, unsigned int seed) {
+  // initstate_r() only accepts a generator without a state.
+  memset(&random->data, 0, sizeof(random->data));
+  initstate_r(seed, random->state, sizeof(random->state), &random->data);
+}
+
+
+int game_board_random_next(struct GameBoardRandom* random) {
+  int32_t value;
+  random_r(&random->data, &value);
+  return value;
+}
+
+
+int game_board_get_neighbours(
+    struct GameBoard* game_board,
+    int index,
+    int neighbours[GAME_BOARD_NEIGHBOUR_MAX]
+) {
+  int count = 0;
+  for (int offset_i = 0; offset_i < GAME_BOARD_NEIGHBOUR_MAX; offset_i++) {
+    int j = index + g_game_board_neighbour_offsets[offset_i];
+    if (game_board->board[j] != BOARD_CELL_TYPE_BORDER) neighbours[count++] = j;
+  }
+  return count;
+}
+
+
+void game_board_set_target(
+    struct GameBoard* game_board,
+    enum GameBoardTarget target,
+    int index,
+    bool value
+) {
+  uint64_t* row = &game_board->targets[target][game_board_get_line(game_board, index)];
+  uint64_t bit = UINT64_C(1) << game_board_get_column(game_board, index);
+  if (value) {
+    *row |= bit;
+  } else {
+    *row &= ~bit;
+  }
+}
+
+
+// The border is never revealed, so its cells need no check here.
+bool game_board_is_frontier(struct GameBoard* game_board, int index) {
+  if (game_board->visibility_map[index]) return false;
+  for (int offset_i = 0; offset_i < GAME_BOARD_NEIGHBOUR_MAX; offset_i++) {
+    if (game_board->visibility_map[index + g_game_board_neighbour_offsets[offset_i]]) return true;
+  }
+  return false;
+}
+
+
+bool game_board_is_unsatisfied(struct GameBoard* game_board, int index) {
+  if (!game_board->visibility_map[index]) return false;
+  int number = game_board->board[index];
+  if (number == BOARD_CELL_TYPE_EMPTY || number == BOARD_CELL_TYPE_MINE) return false;
+  // Nor does it hold markers.
+  int marker_count = 0;
+  for (int offset_i = 0; offset_i < GAME_BOARD_NEIGHBOUR_MAX; offset_i++) {
+    int j = index + g_game_board_neighbour_offsets[offset_i];
+    marker_count += !game_board->visibility_map[j]
+      && game_board->markers[j] == BOARD_CELL_TYPE_MINE_MARKER;
+  }
+  return marker_count != number;
+}
+
+
+void game_board_clear_targets(struct GameBoard* game_board) {
+  for (int target = 0; target < GAME_BOARD_TARGET_MAX; target++) {
+    for (int y = 0; y < GAME_BOARD_HEIGHT_MAX; y++) {
+      game_board->targets[target][y] = 0;
+    }
+  }
+}
+
+
+void game_board_reset_targets(struct GameBoard* game_board) {
+  game_board_clear_targets(game_board);
+  for (int y = 0; y < game_board->height; y++) {
+    for (int x = 0; x < game_board->width; x++) {
+      int i = game_board_get_index(game_board, x, y);
+      if (game_board_is_frontier(game_board, i)) {
+        game_board_set_target(game_board, GAME_BOARD_TARGET_FRONTIER, i, true);
+      }
+      if (game_board_is_unsatisfied(game_board, i)) {
+        game_board_set_target(game_board, GAME_BOARD_TARGET_UNSATISFIED, i, true);
       }
     }
   }
 }
 
 
-void game_board_show_all(struct GameBoard* game_board) {
-  for (int i = 0; i < game_board->width * game_board->height; i++) {
-    game_board->visibility_map[i]  = true;
+// A revealed cell leaves the frontier and pushes it to its hidden neighbours.
+// If it had a mine marker, that marker stops counting for the numbers around.
+void game_board_update_targets_on_reveal(struct GameBoard* game_board, int index) {
+  game_board_set_target(game_board, GAME_BOARD_TARGET_FRONTIER, index, false);
+  game_board_set_target(
+      game_board,
+      GAME_BOARD_TARGET_UNSATISFIED,
+      index,
+      game_board_is_unsatisfied(game_board, index)
+  );
+  bool had_mine_marker = game_board->markers[index] == BOARD_CELL_TYPE_MINE_MARKER;
+  int neighbours[GAME_BOARD_NEIGHBOUR_MAX];
+  int count = game_board_get_neighbours(game_board, index, neighbours);
+  for (int i = 0; i < count; i++) {
+    int j = neighbours[i];
+    if (game_board->visibility_map[j]) {
+      if (!had_mine_marker) continue;
+      game_board_set_target(
+          game_board,
+          GAME_BOARD_TARGET_UNSATISFIED,
+          j,
+          game_board_is_unsatisfied(game_board, j)
+      );
+    } else {
+      game_board_set_target(game_board, GAME_BOARD_TARGET_FRONTIER, j, true);
+    }
   }
 }
 
 
-void game_board_play_cell(struct GameBoard* game_board, int x, int y) {
-  log_info_f("game_board_play_cell(game_board, %d, %d)", x, y);
+// A marker only changes how satisfied the numbers around it are.
+void game_board_update_targets_on_marker(struct GameBoard* game_board, int index) {
+  int neighbours[GAME_BOARD_NEIGHBOUR_MAX];
+  int count = game_board_get_neighbours(game_board, index, neighbours);
+  for (int i = 0; i < count; i++) {
+    game_board_set_target(
+        game_board,
+        GAME_BOARD_TARGET_UNSATISFIED,
+        neighbours[i],
+        game_board_is_unsatisfied(game_board, neighbours[i])
+    );
+  }
+}
 
-  char* board = game_board->board;
-  bool* visibility_map = game_board->visibility_map;
-  int width = game_board->width;
-
-  int offsets[] = {1, -1, width, -width};
-  int cells[GAME_BOARD_SIZE_MAX];
-  int cells_size = 1;
-
-  cells[0] = game_board_get_index(game_board, x, y);
-  for (int i = 0; i < cells_size && i < GAME_BOARD_SIZE_MAX; i++) {
-    if (visibility_map[cells[i]]) continue;
-    visibility_map[cells[i]] = true;
-    if (board[cells[i]] != BOARD_CELL_TYPE_EMPTY) continue;
-    for (int j = 0; j < array_size(offsets); j++) {
-      int cell = cells[i] + offsets[j];
-      if (cell < 0 || cell >= game_board_max_index(game_board)) continue;
-      if (visibility_map[cell]) continue;
-      if (
-        j <= 1 
-        && game_board_get_line(game_board, cell) != game_board_get_line(game_board, cells[i])
-      ) continue;
-      cells[cells_size++] = cell;
+
+/*
+ * Find the next (direction > 0) or previous (direction < 0) target cell from
+ * `from` in reading order, wrapping around the board. Rows are scanned a word
+ * at a time with a bit scan so empty rows cost one test.
+ */
+bool game_board_find_target(
+    struct GameBoard* game_board,
+    enum GameBoardTarget target,
+    int from,
+    int direction,
+    int* found
+) {
+  const uint64_t* rows = game_board->targets[target];
+  int height = game_board->height;
+  int x = game_board_get_column(game_board, from);
+  int y = game_board_get_line(game_board, from);
+
+  // The first word only holds the cells strictly after/before `from`.
+  uint64_t word;
+  if (direction > 0) {
+    word = x + 1 < 64 ? rows[y] & (~UINT64_C(0) << (x + 1)) : 0;
+  } else {
+    word = rows[y] & ((UINT64_C(1) << x) - 1);
+  }
+
+  // One extra row to come back to the start row from the other side.
+  for (int i = 0; i <= height; i++) {
+    if (word != 0) {
+      int column = direction > 0 ? __builtin_ctzll(word) : 63 - __builtin_clzll(word);
+      *found = game_board_get_index(game_board, column, y);
+      return true;
+    }
+    y = direction > 0 ? (y + 1) % height : (y + height - 1) % height;
+    word = rows[y];
+  }
+  return false;
+}
+
+
+bool game_board_jump_to_target(
+    struct GameBoard* game_board,
+    struct Cursor* cursor,
+    enum GameBoardTarget target,
+    int direction
+) {
+  int from = game_board_get_index(game_board, cursor->x, cursor->y);
+  int found;
+  if (!game_board_find_target(game_board, target, from, direction, &found)) return false;
+  cursor->x = game_board_get_column(game_board, found);
+  cursor->y = game_board_get_line(game_board, found);
+  return true;
+}
+
+
+void game_board_show_all(struct GameBoard* game_board, struct GameBoardDelta* delta) {
+  for (int y = 0; y < game_board->height; y++) {
+    for (int x = 0; x < game_board->width; x++) {
+      game_board->visibility_map[game_board_get_index(game_board, x, y)] = true;
     }
   }
+  game_board->revealed_count = game_board_get_cell_count(game_board);
+  game_board->revealed_mine_count = game_board->mine_count;
+  game_board_delta_invalidate(delta);
+  game_board_reset_targets(game_board);
+}
+
+
+void game_board_reveal(struct GameBoard* game_board, int index, struct GameBoardDelta* delta) {
+  game_board->visibility_map[index] = true;
+  game_board->revealed_count++;
+  if (game_board->board[index] == BOARD_CELL_TYPE_MINE) game_board->revealed_mine_count++;
+  game_board_delta_record(delta, index);
+  game_board_update_targets_on_reveal(game_board, index);
+}
+
+
+// Rows and columns may run one cell into the border, which is skipped.
+void game_board_reveal_row(
+    struct GameBoard* game_board,
+    int y,
+    int x_begin,
+    int x_end,
+    struct GameBoardDelta* delta
+) {
+  int end = game_board_get_index(game_board, x_end, y);
+  for (int i = game_board_get_index(game_board, x_begin, y); i < end; i++) {
+    if (game_board->visibility_map[i] || game_board->board[i] == BOARD_CELL_TYPE_BORDER) continue;
+    game_board_reveal(game_board, i, delta);
+  }
+}
+
 
+/*
+ * Reveal the empty cells of an opening and the numbers around them. An
+ * opening is never partly revealed, so the cells already visible are the
+ * numbers it shares with openings revealed before.
+ */
+void game_board_reveal_opening(
+    struct GameBoard* game_board,
+    int opening,
+    struct GameBoardDelta* delta
+) {
+  const struct GameBoardSpan* spans = game_board->opening_spans;
+  int span_end = game_board->opening_first_spans[opening + 1];
+  for (int span_i = game_board->opening_first_spans[opening]; span_i < span_end; span_i++) {
+    const struct GameBoardSpan* span = &spans[span_i];
+    int x_end = span->x + span->length;
+    game_board_reveal_row(game_board, span->y - 1, span->x, x_end, delta);
+    game_board_reveal_row(game_board, span->y, span->x - 1, x_end + 1, delta);
+    game_board_reveal_row(game_board, span->y + 1, span->x, x_end, delta);
+  }
 }
 
 
-void game_board_switch_ok_marker(struct GameBoard* game_board, int x, int y) {
+/*
+ * The played cell comes first in the delta, then the rest of its opening in
+ * reading order.
+ */
+void game_board_play_cell(
+    struct GameBoard* game_board,
+    int x,
+    int y,
+    struct GameBoardDelta* delta
+) {
+  log_info_f("game_board_play_cell(game_board, %d, %d)", x, y);
+
+  int index = game_board_get_index(game_board, x, y);
+  if (game_board->visibility_map[index]) return;
+  trace_begin(TRACE_NAME_PLAY_CELL);
+  game_board_reveal(game_board, index, delta);
+  int opening = game_board->opening_labels[index];
+  if (opening >= 0) game_board_reveal_opening(game_board, opening, delta);
+  trace_end(TRACE_NAME_PLAY_CELL);
+}
+
+
+/*
+ * Reveal the unmarked neighbours of a revealed number once all of its mines
+ * are marked.
+ */
+void game_board_chord(
+    struct GameBoard* game_board,
+    int x,
+    int y,
+    struct GameBoardDelta* delta
+) {
+  log_info_f("game_board_chord(game_board, %d, %d)", x, y);
+  int index = game_board_get_index(game_board, x, y);
+  int number = game_board->board[index];
+  if (!game_board->visibility_map[index]) return;
+  if (number == BOARD_CELL_TYPE_EMPTY || number == BOARD_CELL_TYPE_MINE) return;
+  if (game_board_is_unsatisfied(game_board, index)) return;
+
+  int neighbours[GAME_BOARD_NEIGHBOUR_MAX];
+  int count = game_board_get_neighbours(game_board, index, neighbours);
+  for (int i = 0; i < count; i++) {
+    int j = neighbours[i];
+    if (game_board->visibility_map[j]) continue;
+    if (game_board->markers[j] == BOARD_CELL_TYPE_MINE_MARKER) continue;
+    game_board_play_cell(
+        game_board,
+        game_board_get_column(game_board, j),
+        game_board_get_line(game_board, j),
+        delta
+    );
+  }
+}
+
+
+void game_board_switch_ok_marker(
+    struct GameBoard* game_board,
+    int x,
+    int y,
+    struct GameBoardDelta* delta
+) {
   log_info_f("game_board_switch_ok_marker(game_board, %d, %d)", x, y);
   char* markers = game_board->markers;
   int i = game_board_get_index(game_board, x, y);
@@ -146,10 +454,17 @@ void game_board_switch_ok_marker(struct GameBoard* game_board, int x, int y) {
   } else {
     markers[i] = BOARD_CELL_TYPE_OK_MARKER;
   }
+  game_board_delta_record(delta, i);
+  game_board_update_targets_on_marker(game_board, i);
 }
 
 
-void game_board_switch_mine_marker(struct GameBoard* game_board, int x, int y) {
+void game_board_switch_mine_marker(
+    struct GameBoard* game_board,
+    int x,
+    int y,
+    struct GameBoardDelta* delta
+) {
   log_info_f("game_board_switch_mine_marker(game_board, %d, %d)", x, y);
   char* markers = game_board->markers;
   int i = game_board_get_index(game_board, x, y);
@@ -158,38 +473,29 @@ void game_board_switch_mine_marker(struct GameBoard* game_board, int x, int y) {
   } else {
     markers[i] = BOARD_CELL_TYPE_MINE_MARKER;
   }
+  game_board_delta_record(delta, i);
+  game_board_update_targets_on_marker(game_board, i);
 }
 
 // Game is won if all hidden cells are mines.
 bool game_board_is_win(struct GameBoard* game_board) {
   log_info("game_board_is_win(game_board)");
-  char* board = game_board->board;
-  bool* visibility_map = game_board->visibility_map;
-
-  for (int i = 0; i < game_board_max_index(game_board); i++) {
-    if (visibility_map[i] && board[i] == BOARD_CELL_TYPE_MINE) return false;
-    if (!visibility_map[i] && board[i] != BOARD_CELL_TYPE_MINE) return false;
-  }
-  return true;
+  return game_board->revealed_mine_count == 0
+    && game_board->revealed_count == game_board_get_cell_count(game_board) - game_board->mine_count;
 }
 
 
 // Game is lost when a mine is visible.
 bool game_board_is_lost(struct GameBoard* game_board) {
   log_info("game_board_is_lost(game_board)");
-  char* board = game_board->board;
-  bool* visibility_map = game_board->visibility_map;
-
-  for (int i = 0; i < game_board_max_index(game_board); i++) {
-    if (visibility_map[i] && board[i] == BOARD_CELL_TYPE_MINE) return true;
-  }
-  return false;
+  return game_board->revealed_mine_count > 0;
 }
 
 
 /*
  * Move the cursor but keep it inside the board.
- * If moved in diagonal, allow displacement on one axis if allowed.
+ * Moves going past an edge stop on that edge, so counted moves like `10`
+ * right on a narrow board end on the last column.
  */
 void game_board_move_cursor(
     struct GameBoard* game_board,
@@ -199,20 +505,252 @@ void game_board_move_cursor(
 ) {
   int newX = cursor->x + x;
   int newY = cursor->y + y;
-  if (newX >= 0 && newX < game_board->width) {
-    cursor->x = newX;
+  if (newX < 0) newX = 0;
+  if (newX >= game_board->width) newX = game_board->width - 1;
+  if (newY < 0) newY = 0;
+  if (newY >= game_board->height) newY = game_board->height - 1;
+  cursor->x = newX;
+  cursor->y = newY;
+}
+
+
+/*
+ * The empty board: its cells form a single opening until mines are set.
+ */
+inline __attribute__((always_inline)) void game_board_clear_cells_kernel(
+    struct GameBoard* game_board,
+    int width,
+    int height
+) {
+  for (int y = -1; y <= height; y++) {
+    bool is_inside = y >= 0 && y < height;
+    int row = game_board_get_index(game_board, 0, y);
+    for (int i = row - 1; i <= row + width; i++) {
+      game_board->board[i] = is_inside ? BOARD_CELL_TYPE_EMPTY : BOARD_CELL_TYPE_BORDER;
+      game_board->visibility_map[i] = false;
+      game_board->markers[i] = BOARD_CELL_TYPE_EMPTY;
+      game_board->opening_labels[i] = is_inside ? 0 : -1;
+    }
+    game_board->board[row - 1] = BOARD_CELL_TYPE_BORDER;
+    game_board->board[row + width] = BOARD_CELL_TYPE_BORDER;
+    game_board->opening_labels[row - 1] = -1;
+    game_board->opening_labels[row + width] = -1;
   }
-  if (newY >= 0 && newY < game_board->height) {
-    cursor->y = newY;
+}
+
+
+int game_board_find_opening(int16_t* parents, int index) {
+  while (parents[index] != index) {
+    parents[index] = parents[parents[index]];
+    index = parents[index];
   }
+  return index;
 }
 
 
-bool game_board_is_new(struct GameBoard* game_board) {
-  for (int i = 0; i < game_board_max_index(game_board); i++) {
-    if (game_board->visibility_map[i]) return false;
+/*
+ * Two row-major passes label the openings. The first joins each empty cell
+ * to the empty cells left of and above it with union-find, since reveals
+ * flood through the 4 neighbours, and always keeps the smaller index as the
+ * root. Every parent then comes before its child, so the second pass reads
+ * the final label of a cell from its parent and collects the empty runs of
+ * each row, which are then bucketed by opening.
+ */
+inline __attribute__((always_inline)) void game_board_index_openings_kernel(
+    struct GameBoard* game_board,
+    int width,
+    int height
+) {
+  const char* board = game_board->board;
+  int16_t* labels = game_board->opening_labels;
+
+  // The border is labelled -1 by `game_board_init`.
+  for (int y = 0; y < height; y++) {
+    int row = game_board_get_index(game_board, 0, y);
+    for (int i = row; i < row + width; i++) {
+      if (board[i] != BOARD_CELL_TYPE_EMPTY) {
+        labels[i] = -1;
+        continue;
+      }
+      bool has_left = labels[i - 1] >= 0;
+      bool has_up = labels[i - GAME_BOARD_STRIDE] >= 0;
+      labels[i] = has_left ? labels[i - 1] : i;
+      // With the cell above left empty, left and up are already joined.
+      if (!has_up || (has_left && labels[i - GAME_BOARD_STRIDE - 1] >= 0)) continue;
+      int up = game_board_find_opening(labels, i - GAME_BOARD_STRIDE);
+      int root = game_board_find_opening(labels, i);
+      if (up < root) {
+        labels[root] = up;
+      } else if (root < up) {
+        labels[up] = root;
+      }
+    }
   }
-  return true;
+
+  struct GameBoardSpan runs[GAME_BOARD_SPAN_MAX];
+  int16_t run_openings[GAME_BOARD_SPAN_MAX];
+  int run_count = 0;
+  int opening_count = 0;
+  for (int y = 0; y < height; y++) {
+    int row = game_board_get_index(game_board, 0, y);
+    int i = row;
+    while (i < row + width) {
+      if (labels[i] < 0) {
+        i++;
+        continue;
+      }
+      // Cells of a run share the label of its first cell.
+      int opening = labels[i] == i ? opening_count++ : labels[labels[i]];
+      int begin = i;
+      for (; labels[i] >= 0; i++) labels[i] = opening;
+      runs[run_count] = (struct GameBoardSpan){y, begin - row, i - begin};
+      run_openings[run_count++] = opening;
+    }
+  }
+
+  // Counting sort of the runs by opening, first_spans is the write cursor
+  // of each opening until it is shifted back to the starts.
+  int16_t* first_spans = game_board->opening_first_spans;
+  for (int opening = 0; opening <= opening_count; opening++) first_spans[opening] = 0;
+  for (int run_i = 0; run_i < run_count; run_i++) first_spans[run_openings[run_i] + 1]++;
+  for (int opening = 0; opening < opening_count; opening++) {
+    first_spans[opening + 1] += first_spans[opening];
+  }
+  for (int run_i = 0; run_i < run_count; run_i++) {
+    game_board->opening_spans[first_spans[run_openings[run_i]]++] = runs[run_i];
+  }
+  for (int opening = opening_count; opening > 0; opening--) {
+    first_spans[opening] = first_spans[opening - 1];
+  }
+  first_spans[0] = 0;
+  game_board->opening_count = opening_count;
+}
+
+
+/*
+ * Bechtel's Board Benchmark Value: the fewest reveals that clear the board.
+ * Each opening takes one click. A number next to an empty cell is revealed
+ * by that opening, any other number takes a click of its own.
+ */
+inline __attribute__((always_inline)) int game_board_count_3bv_kernel(
+    struct GameBoard* game_board,
+    int width,
+    int height
+) {
+  const char* board = game_board->board;
+  int isolated_count = 0;
+
+  for (int y = 0; y < height; y++) {
+    int row = game_board_get_index(game_board, 0, y);
+    for (int i = row; i < row + width; i++) {
+      char cell = board[i];
+      if (cell == BOARD_CELL_TYPE_MINE || cell == BOARD_CELL_TYPE_EMPTY) continue;
+      bool has_left = board[i - 1] == BOARD_CELL_TYPE_EMPTY;
+      bool has_up = board[i - GAME_BOARD_STRIDE] == BOARD_CELL_TYPE_EMPTY;
+      bool has_right = board[i + 1] == BOARD_CELL_TYPE_EMPTY;
+      bool has_down = board[i + GAME_BOARD_STRIDE] == BOARD_CELL_TYPE_EMPTY;
+      if (!has_left && !has_up && !has_right && !has_down) isolated_count++;
+    }
+  }
+  return game_board->opening_count + isolated_count;
+}
+
+
+/*
+ * Mines are drawn in the same order whatever the kernel, so a seed gives
+ * the same board.
+ */
+inline __attribute__((always_inline)) void game_board_generate_kernel(
+    struct GameBoard* game_board,
+    int pourcentage,
+    struct GameBoardRandom* random,
+    int width,
+    int height
+) {
+  int cell_count = width * height;
+  char* board = game_board->board;
+  int bomb_count = (int)(cell_count * pourcentage / 100);
+
+  // Set random mines
+  for (int i = 0; i < bomb_count; i++) {
+    int x = game_board_random_next(random) % width;
+    int y = game_board_random_next(random) % height;
+    int index = game_board_get_index(game_board, x, y);
+    if (board[index] != BOARD_CELL_TYPE_MINE) game_board->mine_count++;
+    board[index] = BOARD_CELL_TYPE_MINE;
+  }
+
+  // Set mine counters. The mines of the 3 rows around a row are summed per
+  // column, then over 3 columns. The border is never a mine so it counts for
+  // nothing, and the counters written on the row above are not mines either.
+  int column_counts[GAME_BOARD_STRIDE];
+  for (int y = 0; y < height; y++) {
+    int row = game_board_get_index(game_board, 0, y);
+    for (int x = -1; x <= width; x++) {
+      int i = row + x;
+      column_counts[x + 1] = (board[i - GAME_BOARD_STRIDE] == BOARD_CELL_TYPE_MINE)
+        + (board[i] == BOARD_CELL_TYPE_MINE)
+        + (board[i + GAME_BOARD_STRIDE] == BOARD_CELL_TYPE_MINE);
+    }
+    for (int x = 0; x < width; x++) {
+      if (board[row + x] == BOARD_CELL_TYPE_MINE) continue;
+      int count = column_counts[x] + column_counts[x + 1] + column_counts[x + 2];
+      board[row + x] = count == 0 ? BOARD_CELL_TYPE_EMPTY : count;
+    }
+  }
+  game_board_index_openings_kernel(game_board, width, height);
+  game_board->bbbv = game_board_count_3bv_kernel(game_board, width, height);
+}
+
+
+int game_board_count_3bv(struct GameBoard* game_board) {
+  return game_board_count_3bv_kernel(game_board, game_board->width, game_board->height);
+}
+
+
+/*
+ * Kernels for one board size. With constant sizes the kernels inlined here
+ * get their loop bounds and modulos resolved at compile time.
+ */
+#define GAME_BOARD_KERNELS(name, kernel_width, kernel_height) \
+  void game_board_clear_cells_##name(struct GameBoard* game_board) { \
+    game_board_clear_cells_kernel(game_board, kernel_width, kernel_height); \
+  } \
+  void game_board_generate_##name( \
+      struct GameBoard* game_board, \
+      int pourcentage, \
+      struct GameBoardRandom* random \
+  ) { \
+    game_board_generate_kernel(game_board, pourcentage, random, kernel_width, kernel_height); \
+  } \
+  const struct GameBoardKernels g_game_board_kernels_##name = { \
+    game_board_clear_cells_##name, \
+    game_board_generate_##name \
+  };
+
+
+GAME_BOARD_KERNELS(easy, GAME_BOARD_EASY_WIDTH, GAME_BOARD_EASY_HEIGHT)
+GAME_BOARD_KERNELS(medium, GAME_BOARD_MEDIUM_WIDTH, GAME_BOARD_MEDIUM_HEIGHT)
+GAME_BOARD_KERNELS(hard, GAME_BOARD_HARD_WIDTH, GAME_BOARD_HARD_HEIGHT)
+GAME_BOARD_KERNELS(any_size, game_board->width, game_board->height)
+
+
+const struct GameBoardKernels* game_board_select_kernels(int width, int height) {
+  if (width == GAME_BOARD_EASY_WIDTH && height == GAME_BOARD_EASY_HEIGHT) {
+    return &g_game_board_kernels_easy;
+  }
+  if (width == GAME_BOARD_MEDIUM_WIDTH && height == GAME_BOARD_MEDIUM_HEIGHT) {
+    return &g_game_board_kernels_medium;
+  }
+  if (width == GAME_BOARD_HARD_WIDTH && height == GAME_BOARD_HARD_HEIGHT) {
+    return &g_game_board_kernels_hard;
+  }
+  return &g_game_board_kernels_any_size;
+}
+
+
+bool game_board_is_new(struct GameBoard* game_board) {
+  return game_board->revealed_count == 0;
 }
 
 
@@ -5,7 +5,10 @@
 #include "util.h"
 #include "cursor.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <curses.h>
+#include "trace.h"
 
 
 #define BOARD_CELL_TYPE_EMPTY ' '
@@ -13,37 +16,194 @@
 #define BOARD_CELL_TYPE_MINE 'M'
 #define BOARD_CELL_TYPE_OK_MARKER 'O'
 #define BOARD_CELL_TYPE_MINE_MARKER 'X'
+// Ghost cells around the board. Never a mine, never revealed.
+#define BOARD_CELL_TYPE_BORDER '#'
+
+// Sizes of the menu difficulties. Boards of these sizes get kernels built
+// for them, see `GameBoardKernels`.
+#define GAME_BOARD_EASY_WIDTH 9
+#define GAME_BOARD_EASY_HEIGHT 5
+#define GAME_BOARD_MEDIUM_WIDTH 17
+#define GAME_BOARD_MEDIUM_HEIGHT 9
+#define GAME_BOARD_HARD_WIDTH 31
+#define GAME_BOARD_HARD_HEIGHT 15
 
 #define GAME_BOARD_WIDTH_MAX 64
 #define GAME_BOARD_HEIGHT_MAX 64
 #define GAME_BOARD_SIZE_MAX (GAME_BOARD_WIDTH_MAX * GAME_BOARD_HEIGHT_MAX)
+// Cells are stored with a ghost border one cell wide and a fixed row
+// stride, so the 8 neighbours of a cell are at constant offsets from it and
+// need no bounds check. Arrays indexed by cell index hold GAME_BOARD_INDEX_MAX.
+#define GAME_BOARD_STRIDE (GAME_BOARD_WIDTH_MAX + 2)
+#define GAME_BOARD_INDEX_MAX (GAME_BOARD_STRIDE * (GAME_BOARD_HEIGHT_MAX + 2))
+#define GAME_BOARD_NEIGHBOUR_MAX 8
+// Empty runs of one row are split by at least one other cell.
+#define GAME_BOARD_SPAN_MAX (GAME_BOARD_HEIGHT_MAX * ((GAME_BOARD_WIDTH_MAX + 1) / 2))
+#define GAME_BOARD_OPENING_MAX GAME_BOARD_SPAN_MAX
+// The state size glibc gives rand(), so both draw the same numbers.
+#define GAME_BOARD_RANDOM_STATE_SIZE 128
+
+
+/**
+ * Cells the cursor can jump to. Each target is a bitset with one 64 bits
+ * word per row, kept up to date on every reveal and marker change.
+ */
+enum GameBoardTarget {
+  // Hidden cells next to a revealed cell.
+  GAME_BOARD_TARGET_FRONTIER,
+  // Revealed numbers whose count of adjacent mine markers does not match.
+  GAME_BOARD_TARGET_UNSATISFIED,
+  GAME_BOARD_TARGET_MAX
+};
+
+
+/**
+ * A run of empty cells on one row, from `x` to `x + length - 1`. The run,
+ * the cell on each side and the same columns on the rows above and below
+ * are what the opening reveals there.
+ */
+struct GameBoardSpan {
+  uint8_t y;
+  uint8_t x;
+  uint8_t length;
+};
+
+
+struct GameBoard;
+
+
+/**
+ * Random numbers drawn by one board setup. Seeded with the board seed it
+ * draws the same numbers as `srand(seed)` then `rand()`, so a seed keeps
+ * its board, but boards set up on different threads share no state.
+ */
+struct GameBoardRandom {
+  struct random_data data;
+  char state[GAME_BOARD_RANDOM_STATE_SIZE];
+};
+
+
+/**
+ * The loops over the whole board, compiled once per menu size with the
+ * size as a constant so they are unrolled and vectorized, and once for any
+ * size. `game_board_init` picks them from the board size.
+ */
+struct GameBoardKernels {
+  // Write the empty board and its border.
+  void (*clear_cells)(struct GameBoard* game_board);
+  // Place the mines, count them around each cell, index the openings and
+  // score the board.
+  void (*generate)(
+      struct GameBoard* game_board,
+      int pourcentage,
+      struct GameBoardRandom* random
+  );
+};
 
 
 struct GameBoard {
   int width;
   int height;
-  char board[GAME_BOARD_SIZE_MAX];
-  bool visibility_map[GAME_BOARD_SIZE_MAX];
-  char markers[GAME_BOARD_SIZE_MAX];
+  const struct GameBoardKernels* kernels;
+  char board[GAME_BOARD_INDEX_MAX];
+  bool visibility_map[GAME_BOARD_INDEX_MAX];
+  char markers[GAME_BOARD_INDEX_MAX];
+  uint64_t targets[GAME_BOARD_TARGET_MAX][GAME_BOARD_HEIGHT_MAX];
+  // Kept up to date on reveal so win and loss checks are O(1).
+  int mine_count;
+  int revealed_count;
+  int revealed_mine_count;
+  // Difficulty of the board, scored by `game_board_setup_game`.
+  int bbbv;
+  // Openings, the 4-connected regions of empty cells, are indexed when the
+  // board is set up so revealing one walks its spans instead of flooding.
+  // Spans of opening `o` are `opening_spans[opening_first_spans[o]]` up to
+  // `opening_first_spans[o + 1]`. Cells that are not empty are labelled -1.
+  int16_t opening_labels[GAME_BOARD_INDEX_MAX];
+  int16_t opening_first_spans[GAME_BOARD_OPENING_MAX + 1];
+  struct GameBoardSpan opening_spans[GAME_BOARD_SPAN_MAX];
+  int opening_count;
+};
+
+
+/**
+ * Cells whose visibility or marker changed, in the order they changed.
+ * Reveal, chord and marker operations append to a delta supplied by the
+ * caller, who clears it once consumed so it is reused without allocation.
+ * When it is full, or the whole board changed, `overflow` is set and
+ * consumers must rescan the board.
+ */
+struct GameBoardDelta {
+  int cells[GAME_BOARD_SIZE_MAX];
+  int count;
+  bool overflow;
 };
 
 
 void game_board_init(struct GameBoard* game_board, int width, int height);
-void game_board_setup_game(struct GameBoard* game_board, int pourcentage);
+void game_board_setup_game(struct GameBoard* game_board, int pourcentage, unsigned int seed);
+void game_board_random_init(struct GameBoardRandom* random, unsigned int seed);
+int game_board_random_next(struct GameBoardRandom* random);
 void game_board_move_cursor(
     struct GameBoard* game_board,
     struct Cursor* cursor,
     int x,
     int y
 );
-void game_board_play_cell(struct GameBoard* game_board, int x, int y);
-void game_board_switch_ok_marker(struct GameBoard* game_board, int x, int y);
-void game_board_switch_mine_marker(struct GameBoard* game_board, int x, int y);
-void game_board_show_all(struct GameBoard* game_board);
+void game_board_play_cell(
+    struct GameBoard* game_board,
+    int x,
+    int y,
+    struct GameBoardDelta* delta
+);
+void game_board_chord(
+    struct GameBoard* game_board,
+    int x,
+    int y,
+    struct GameBoardDelta* delta
+);
+void game_board_switch_ok_marker(
+    struct GameBoard* game_board,
+    int x,
+    int y,
+    struct GameBoardDelta* delta
+);
+void game_board_switch_mine_marker(
+    struct GameBoard* game_board,
+    int x,
+    int y,
+    struct GameBoardDelta* delta
+);
+void game_board_show_all(struct GameBoard* game_board, struct GameBoardDelta* delta);
 bool game_board_is_win(struct GameBoard* game_board);
 bool game_board_is_lost(struct GameBoard* game_board);
 int game_board_get_index(struct GameBoard* game_board, int x, int y);
+int game_board_get_cell_count(struct GameBoard* game_board);
+int game_board_get_line(struct GameBoard* game_board, int index);
+int game_board_get_column(struct GameBoard* game_board, int index);
+bool game_board_is_new(struct GameBoard* game_board);
 bool game_board_is_playing(struct GameBoard* game_board);
+void game_board_delta_clear(struct GameBoardDelta* delta);
+void game_board_delta_invalidate(struct GameBoardDelta* delta);
+int game_board_get_neighbours(
+    struct GameBoard* game_board,
+    int index,
+    int neighbours[GAME_BOARD_NEIGHBOUR_MAX]
+);
+bool game_board_find_target(
+    struct GameBoard* game_board,
+    enum GameBoardTarget target,
+    int from,
+    int direction,
+    int* found
+);
+int game_board_count_3bv(struct GameBoard* game_board);
+bool game_board_jump_to_target(
+    struct GameBoard* game_board,
+    struct Cursor* cursor,
+    enum GameBoardTarget target,
+    int direction
+);
 
 
 #endif
@@ -0,0 +1,232 @@
+#include "game_board_reference.h"
+
+
+bool game_board_reference_is_inside(struct GameBoard* game_board, int x, int y) {
+  return x >= 0 && x < game_board->width && y >= 0 && y < game_board->height;
+}
+
+
+char* game_board_reference_cell(struct GameBoard* game_board, int x, int y) {
+  return &game_board->board[game_board_get_index(game_board, x, y)];
+}
+
+
+bool* game_board_reference_visibility(struct GameBoard* game_board, int x, int y) {
+  return &game_board->visibility_map[game_board_get_index(game_board, x, y)];
+}
+
+
+char* game_board_reference_marker(struct GameBoard* game_board, int x, int y) {
+  return &game_board->markers[game_board_get_index(game_board, x, y)];
+}
+
+
+/*
+ * Draw the mines with the same random numbers as the optimized version,
+ * then count the mines around every cell.
+ */
+void game_board_reference_setup_game(
+    struct GameBoard* game_board,
+    int pourcentage,
+    unsigned int seed
+) {
+  struct GameBoardRandom random;
+  game_board_random_init(&random, seed);
+  int width = game_board->width;
+  int height = game_board->height;
+  int bomb_count = width * height * pourcentage / 100;
+  for (int i = 0; i < bomb_count; i++) {
+    int x = game_board_random_next(&random) % width;
+    int y = game_board_random_next(&random) % height;
+    *game_board_reference_cell(game_board, x, y) = BOARD_CELL_TYPE_MINE;
+  }
+
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      char* cell = game_board_reference_cell(game_board, x, y);
+      if (*cell == BOARD_CELL_TYPE_MINE) continue;
+      int count = 0;
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          if (!game_board_reference_is_inside(game_board, x + dx, y + dy)) continue;
+          if (*game_board_reference_cell(game_board, x + dx, y + dy) == BOARD_CELL_TYPE_MINE) {
+            count++;
+          }
+        }
+      }
+      *cell = count == 0 ? BOARD_CELL_TYPE_EMPTY : count;
+    }
+  }
+}
+
+
+/*
+ * Show the cell and, when it is empty, flood its 4 neighbours recursively.
+ * Markers do not stop the flood.
+ */
+void game_board_reference_play_cell(struct GameBoard* game_board, int x, int y) {
+  if (!game_board_reference_is_inside(game_board, x, y)) return;
+  bool* visible = game_board_reference_visibility(game_board, x, y);
+  if (*visible) return;
+  *visible = true;
+  if (*game_board_reference_cell(game_board, x, y) != BOARD_CELL_TYPE_EMPTY) return;
+  game_board_reference_play_cell(game_board, x + 1, y);
+  game_board_reference_play_cell(game_board, x - 1, y);
+  game_board_reference_play_cell(game_board, x, y + 1);
+  game_board_reference_play_cell(game_board, x, y - 1);
+}
+
+
+int game_board_reference_count_mine_markers(struct GameBoard* game_board, int x, int y) {
+  int count = 0;
+  for (int dy = -1; dy <= 1; dy++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      if (dx == 0 && dy == 0) continue;
+      if (!game_board_reference_is_inside(game_board, x + dx, y + dy)) continue;
+      if (*game_board_reference_visibility(game_board, x + dx, y + dy)) continue;
+      if (*game_board_reference_marker(game_board, x + dx, y + dy) == BOARD_CELL_TYPE_MINE_MARKER) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+
+bool game_board_reference_is_number(struct GameBoard* game_board, int x, int y) {
+  char cell = *game_board_reference_cell(game_board, x, y);
+  return cell != BOARD_CELL_TYPE_EMPTY && cell != BOARD_CELL_TYPE_MINE;
+}
+
+
+void game_board_reference_chord(struct GameBoard* game_board, int x, int y) {
+  if (!*game_board_reference_visibility(game_board, x, y)) return;
+  if (!game_board_reference_is_number(game_board, x, y)) return;
+  int number = *game_board_reference_cell(game_board, x, y);
+  if (game_board_reference_count_mine_markers(game_board, x, y) != number) return;
+  for (int dy = -1; dy <= 1; dy++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      if (!game_board_reference_is_inside(game_board, x + dx, y + dy)) continue;
+      if (*game_board_reference_marker(game_board, x + dx, y + dy) == BOARD_CELL_TYPE_MINE_MARKER) {
+        continue;
+      }
+      game_board_reference_play_cell(game_board, x + dx, y + dy);
+    }
+  }
+}
+
+
+void game_board_reference_switch_marker(
+    struct GameBoard* game_board,
+    int x,
+    int y,
+    char marker
+) {
+  char* cell = game_board_reference_marker(game_board, x, y);
+  *cell = *cell == marker ? (char)BOARD_CELL_TYPE_HIDDEN : marker;
+}
+
+
+void game_board_reference_switch_ok_marker(struct GameBoard* game_board, int x, int y) {
+  game_board_reference_switch_marker(game_board, x, y, BOARD_CELL_TYPE_OK_MARKER);
+}
+
+
+void game_board_reference_switch_mine_marker(struct GameBoard* game_board, int x, int y) {
+  game_board_reference_switch_marker(game_board, x, y, BOARD_CELL_TYPE_MINE_MARKER);
+}
+
+
+// Won when every cell left hidden is a mine and no mine is shown.
+bool game_board_reference_is_win(struct GameBoard* game_board) {
+  for (int y = 0; y < game_board->height; y++) {
+    for (int x = 0; x < game_board->width; x++) {
+      bool is_mine = *game_board_reference_cell(game_board, x, y) == BOARD_CELL_TYPE_MINE;
+      if (is_mine == *game_board_reference_visibility(game_board, x, y)) return false;
+    }
+  }
+  return true;
+}
+
+
+bool game_board_reference_is_lost(struct GameBoard* game_board) {
+  for (int y = 0; y < game_board->height; y++) {
+    for (int x = 0; x < game_board->width; x++) {
+      if (*game_board_reference_cell(game_board, x, y) != BOARD_CELL_TYPE_MINE) continue;
+      if (*game_board_reference_visibility(game_board, x, y)) return true;
+    }
+  }
+  return false;
+}
+
+
+bool game_board_reference_is_target(
+    struct GameBoard* game_board,
+    enum GameBoardTarget target,
+    int x,
+    int y
+) {
+  bool visible = *game_board_reference_visibility(game_board, x, y);
+  switch (target) {
+    case GAME_BOARD_TARGET_FRONTIER:
+      if (visible) return false;
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          if (!game_board_reference_is_inside(game_board, x + dx, y + dy)) continue;
+          if (*game_board_reference_visibility(game_board, x + dx, y + dy)) return true;
+        }
+      }
+      return false;
+    case GAME_BOARD_TARGET_UNSATISFIED:
+      if (!visible || !game_board_reference_is_number(game_board, x, y)) return false;
+      return game_board_reference_count_mine_markers(game_board, x, y)
+        != *game_board_reference_cell(game_board, x, y);
+    default:
+      return false;
+  }
+}
+
+
+/*
+ * Flood each opening the way a reveal does, then count the safe cells no
+ * opening reached.
+ */
+int game_board_reference_count_3bv(struct GameBoard* game_board) {
+  bool reached[GAME_BOARD_SIZE_MAX];
+  int cells[GAME_BOARD_SIZE_MAX];
+  int width = game_board->width;
+  int height = game_board->height;
+  for (int i = 0; i < width * height; i++) reached[i] = false;
+
+  int count = 0;
+  for (int start = 0; start < width * height; start++) {
+    if (*game_board_reference_cell(game_board, start % width, start / width) != BOARD_CELL_TYPE_EMPTY) {
+      continue;
+    }
+    if (reached[start]) continue;
+    count++;
+    int cells_size = 1;
+    cells[0] = start;
+    reached[start] = true;
+    for (int i = 0; i < cells_size; i++) {
+      int x = cells[i] % width;
+      int y = cells[i] / width;
+      if (*game_board_reference_cell(game_board, x, y) != BOARD_CELL_TYPE_EMPTY) continue;
+      int neighbours[][2] = {{x + 1, y}, {x - 1, y}, {x, y + 1}, {x, y - 1}};
+      for (int j = 0; j < array_size(neighbours); j++) {
+        int nx = neighbours[j][0];
+        int ny = neighbours[j][1];
+        if (!game_board_reference_is_inside(game_board, nx, ny)) continue;
+        if (reached[ny * width + nx]) continue;
+        reached[ny * width + nx] = true;
+        cells[cells_size++] = ny * width + nx;
+      }
+    }
+  }
+
+  for (int i = 0; i < width * height; i++) {
+    if (reached[i]) continue;
+    if (*game_board_reference_cell(game_board, i % width, i / width) != BOARD_CELL_TYPE_MINE) count++;
+  }
+  return count;
+}
@@ -0,0 +1,35 @@
+#ifndef GAME_BOARD_REFERENCE_H
+#define GAME_BOARD_REFERENCE_H
+
+
+#include "game_board.h"
+
+
+/**
+ * The simplest possible versions of the game board kernels. They are the
+ * specification the optimized versions in game_board.c are checked against
+ * with `--difftest`, so they favour being obviously right over being fast.
+ * They only use the board, visibility and marker arrays, never the
+ * counters, targets or deltas.
+ */
+void game_board_reference_setup_game(
+    struct GameBoard* game_board,
+    int pourcentage,
+    unsigned int seed
+);
+void game_board_reference_play_cell(struct GameBoard* game_board, int x, int y);
+void game_board_reference_chord(struct GameBoard* game_board, int x, int y);
+void game_board_reference_switch_ok_marker(struct GameBoard* game_board, int x, int y);
+void game_board_reference_switch_mine_marker(struct GameBoard* game_board, int x, int y);
+bool game_board_reference_is_win(struct GameBoard* game_board);
+bool game_board_reference_is_lost(struct GameBoard* game_board);
+int game_board_reference_count_3bv(struct GameBoard* game_board);
+bool game_board_reference_is_target(
+    struct GameBoard* game_board,
+    enum GameBoardTarget target,
+    int x,
+    int y
+);
+
+
+#endif
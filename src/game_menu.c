@@ -5,12 +5,13 @@ const char* g_menu_items[] = {
   "Resume",
   "New Game",
   "Manual",
+  "Stats",
   "Quit"
 };
 
 
-const int new_game_items[] = {1, 2, 3};
-const int in_game_items[] = {0, 1, 2, 3};
+const int new_game_items[] = {1, 2, 3, 4};
+const int in_game_items[] = {0, 1, 2, 3, 4};
 
 
 void game_menu_init_new_game(struct ItemSelection* item_selection) {
@@ -13,6 +13,7 @@ enum GameMenuCommand {
   GAME_MENU_RESUME,
   GAME_MENU_NEW_GAME,
   GAME_MENU_MANUAL,
+  GAME_MENU_STATS,
   GAME_MENU_QUIT,
   GAME_MENU_COMMAND_MAX
 };
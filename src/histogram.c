@@ -0,0 +1,63 @@
+#include "histogram.h"
+
+
+void histogram_init(struct Histogram* histogram) {
+  for (int i = 0; i < HISTOGRAM_BUCKET_COUNT; i++) histogram->counts[i] = 0;
+  histogram->count = 0;
+  histogram->min = 0;
+  histogram->max = 0;
+  histogram->sum = 0;
+}
+
+
+int histogram_get_bucket(long value) {
+  if (value < HISTOGRAM_SUB_BUCKET_COUNT) return value;
+  int exponent = 63 - __builtin_clzl(value);
+  int shift = exponent - HISTOGRAM_SUB_BUCKET_BITS;
+  int sub_bucket = (value >> shift) & (HISTOGRAM_SUB_BUCKET_COUNT - 1);
+  return HISTOGRAM_SUB_BUCKET_COUNT + shift * HISTOGRAM_SUB_BUCKET_COUNT + sub_bucket;
+}
+
+
+long histogram_get_bucket_start(int bucket) {
+  if (bucket < HISTOGRAM_SUB_BUCKET_COUNT) return bucket;
+  int shift = (bucket - HISTOGRAM_SUB_BUCKET_COUNT) / HISTOGRAM_SUB_BUCKET_COUNT;
+  int sub_bucket = (bucket - HISTOGRAM_SUB_BUCKET_COUNT) % HISTOGRAM_SUB_BUCKET_COUNT;
+  return (long)(HISTOGRAM_SUB_BUCKET_COUNT + sub_bucket) << shift;
+}
+
+
+void histogram_record(struct Histogram* histogram, long value) {
+  if (value < 0) value = 0;
+  histogram->counts[histogram_get_bucket(value)]++;
+  if (histogram->count == 0 || value < histogram->min) histogram->min = value;
+  if (histogram->count == 0 || value > histogram->max) histogram->max = value;
+  histogram->count++;
+  histogram->sum += value;
+}
+
+
+/**
+ * Highest value of the bucket holding the given percentile (0 to 100).
+ */
+long histogram_get_percentile(struct Histogram* histogram, double percentile) {
+  if (histogram->count == 0) return 0;
+  long rank = (long)(percentile / 100.0 * histogram->count + 0.5);
+  if (rank < 1) rank = 1;
+  long seen = 0;
+  for (int bucket = 0; bucket < HISTOGRAM_BUCKET_COUNT; bucket++) {
+    seen += histogram->counts[bucket];
+    if (seen < rank) continue;
+    long highest = bucket + 1 < HISTOGRAM_BUCKET_COUNT
+      ? histogram_get_bucket_start(bucket + 1) - 1
+      : histogram->max;
+    return highest < histogram->max ? highest : histogram->max;
+  }
+  return histogram->max;
+}
+
+
+double histogram_get_mean(struct Histogram* histogram) {
+  if (histogram->count == 0) return 0;
+  return histogram->sum / histogram->count;
+}
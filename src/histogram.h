@@ -0,0 +1,35 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+
+#include <stdint.h>
+
+
+// Values are bucketed by power of 2, each split in 2^4 linear sub-buckets,
+// so any recorded value is known within 1/16 (about 6%).
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+#define HISTOGRAM_SUB_BUCKET_COUNT (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_BUCKET_COUNT \
+  (HISTOGRAM_SUB_BUCKET_COUNT + (64 - HISTOGRAM_SUB_BUCKET_BITS) * HISTOGRAM_SUB_BUCKET_COUNT)
+
+
+/**
+ * HDR style histogram of non negative values. Recording is O(1) and the
+ * memory does not depend on the range of the values.
+ */
+struct Histogram {
+  long counts[HISTOGRAM_BUCKET_COUNT];
+  long count;
+  long min;
+  long max;
+  double sum;
+};
+
+
+void histogram_init(struct Histogram* histogram);
+void histogram_record(struct Histogram* histogram, long value);
+long histogram_get_percentile(struct Histogram* histogram, double percentile);
+double histogram_get_mean(struct Histogram* histogram);
+
+
+#endif
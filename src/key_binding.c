@@ -0,0 +1,315 @@
+#include "key_binding.h"
+#include "log.h"
+
+
+#define KEY_BINDING_LINE_MAX 256
+#define KEY_BINDING_TOKEN_MAX 32
+#define key_binding_key_name(key) [key] = #key
+
+
+const char* g_key_binding_key_names[KEY_BINDING_KEY_COUNT] = {
+  [KEY_ESC] = "KEY_ESC",
+  [' '] = "KEY_SPACE",
+  ['\t'] = "KEY_TAB",
+  ['\n'] = "KEY_NEWLINE",
+  key_binding_key_name(KEY_BREAK),
+  key_binding_key_name(KEY_DOWN),
+  key_binding_key_name(KEY_UP),
+  key_binding_key_name(KEY_LEFT),
+  key_binding_key_name(KEY_RIGHT),
+  key_binding_key_name(KEY_HOME),
+  key_binding_key_name(KEY_BACKSPACE),
+  key_binding_key_name(KEY_F0),
+  key_binding_key_name(KEY_DL),
+  key_binding_key_name(KEY_IL),
+  key_binding_key_name(KEY_DC),
+  key_binding_key_name(KEY_IC),
+  key_binding_key_name(KEY_EIC),
+  key_binding_key_name(KEY_CLEAR),
+  key_binding_key_name(KEY_EOS),
+  key_binding_key_name(KEY_EOL),
+  key_binding_key_name(KEY_SF),
+  key_binding_key_name(KEY_SR),
+  key_binding_key_name(KEY_NPAGE),
+  key_binding_key_name(KEY_PPAGE),
+  key_binding_key_name(KEY_STAB),
+  key_binding_key_name(KEY_CTAB),
+  key_binding_key_name(KEY_CATAB),
+  key_binding_key_name(KEY_ENTER),
+  key_binding_key_name(KEY_SRESET),
+  key_binding_key_name(KEY_RESET),
+  key_binding_key_name(KEY_PRINT),
+  key_binding_key_name(KEY_LL),
+  key_binding_key_name(KEY_A1),
+  key_binding_key_name(KEY_A3),
+  key_binding_key_name(KEY_B2),
+  key_binding_key_name(KEY_C1),
+  key_binding_key_name(KEY_C3),
+  key_binding_key_name(KEY_BTAB),
+  key_binding_key_name(KEY_BEG),
+  key_binding_key_name(KEY_CANCEL),
+  key_binding_key_name(KEY_CLOSE),
+  key_binding_key_name(KEY_COMMAND),
+  key_binding_key_name(KEY_COPY),
+  key_binding_key_name(KEY_CREATE),
+  key_binding_key_name(KEY_END),
+  key_binding_key_name(KEY_EXIT),
+  key_binding_key_name(KEY_FIND),
+  key_binding_key_name(KEY_HELP),
+  key_binding_key_name(KEY_MARK),
+  key_binding_key_name(KEY_MESSAGE),
+  key_binding_key_name(KEY_MOUSE),
+  key_binding_key_name(KEY_MOVE),
+  key_binding_key_name(KEY_NEXT),
+  key_binding_key_name(KEY_OPEN),
+  key_binding_key_name(KEY_OPTIONS),
+  key_binding_key_name(KEY_PREVIOUS),
+  key_binding_key_name(KEY_REDO),
+  key_binding_key_name(KEY_REFERENCE),
+  key_binding_key_name(KEY_REFRESH),
+  key_binding_key_name(KEY_REPLACE),
+  key_binding_key_name(KEY_RESIZE),
+  key_binding_key_name(KEY_RESTART),
+  key_binding_key_name(KEY_RESUME),
+  key_binding_key_name(KEY_SAVE),
+  key_binding_key_name(KEY_SBEG),
+  key_binding_key_name(KEY_SCANCEL),
+  key_binding_key_name(KEY_SCOMMAND),
+  key_binding_key_name(KEY_SCOPY),
+  key_binding_key_name(KEY_SCREATE),
+  key_binding_key_name(KEY_SDC),
+  key_binding_key_name(KEY_SDL),
+  key_binding_key_name(KEY_SELECT),
+  key_binding_key_name(KEY_SEND),
+  key_binding_key_name(KEY_SEOL),
+  key_binding_key_name(KEY_SEXIT),
+  key_binding_key_name(KEY_SFIND),
+  key_binding_key_name(KEY_SHELP),
+  key_binding_key_name(KEY_SHOME),
+  key_binding_key_name(KEY_SIC),
+  key_binding_key_name(KEY_SLEFT),
+  key_binding_key_name(KEY_SMESSAGE),
+  key_binding_key_name(KEY_SMOVE),
+  key_binding_key_name(KEY_SNEXT),
+  key_binding_key_name(KEY_SOPTIONS),
+  key_binding_key_name(KEY_SPREVIOUS),
+  key_binding_key_name(KEY_SPRINT),
+  key_binding_key_name(KEY_SREDO),
+  key_binding_key_name(KEY_SREPLACE),
+  key_binding_key_name(KEY_SRIGHT),
+  key_binding_key_name(KEY_SRSUME),
+  key_binding_key_name(KEY_SSAVE),
+  key_binding_key_name(KEY_SSUSPEND),
+  key_binding_key_name(KEY_SUNDO),
+  key_binding_key_name(KEY_SUSPEND),
+  key_binding_key_name(KEY_UNDO),
+};
+
+
+const char* g_key_binding_action_names[KEY_ACTION_MAX] = {
+  [KEY_ACTION_NONE] = "none",
+  [KEY_ACTION_MOVE_UP] = "move_up",
+  [KEY_ACTION_MOVE_DOWN] = "move_down",
+  [KEY_ACTION_MOVE_LEFT] = "move_left",
+  [KEY_ACTION_MOVE_RIGHT] = "move_right",
+  [KEY_ACTION_PLAY] = "play",
+  [KEY_ACTION_CHORD] = "chord",
+  [KEY_ACTION_OK_MARKER] = "ok_marker",
+  [KEY_ACTION_MINE_MARKER] = "mine_marker",
+  [KEY_ACTION_TOGGLE_MINIMAP] = "toggle_minimap",
+  [KEY_ACTION_TOGGLE_ANIMATION] = "toggle_animation",
+  [KEY_ACTION_TOGGLE_HUD] = "toggle_hud",
+  [KEY_ACTION_SELECT] = "select",
+  [KEY_ACTION_START_MENU] = "start_menu",
+  [KEY_ACTION_COUNT] = "count",
+  [KEY_ACTION_NEXT_FRONTIER] = "next_frontier",
+  [KEY_ACTION_PREVIOUS_FRONTIER] = "previous_frontier",
+  [KEY_ACTION_NEXT_UNSATISFIED] = "next_unsatisfied",
+  [KEY_ACTION_PREVIOUS_UNSATISFIED] = "previous_unsatisfied",
+};
+
+
+const char* g_key_binding_state_names[GAME_STATE_MAX] = {
+  [GAME_STATE_START_MENU] = "start_menu",
+  [GAME_STATE_IN_GAME] = "in_game",
+  [GAME_STATE_GAME_OVER] = "game_over",
+  [GAME_STATE_GAME_WON] = "game_won",
+  [GAME_STATE_MENU] = "menu",
+  [GAME_STATE_MANUAL] = "manual",
+  [GAME_STATE_STATS] = "stats",
+  [GAME_STATE_QUIT] = "quit",
+};
+
+
+// Action taken by keys that have no explicit binding in a given state.
+const enum KeyAction g_key_binding_default_actions[GAME_STATE_MAX] = {
+  [GAME_STATE_START_MENU] = KEY_ACTION_SELECT,
+  [GAME_STATE_IN_GAME] = KEY_ACTION_NONE,
+  [GAME_STATE_GAME_OVER] = KEY_ACTION_START_MENU,
+  [GAME_STATE_GAME_WON] = KEY_ACTION_START_MENU,
+  [GAME_STATE_MENU] = KEY_ACTION_SELECT,
+  [GAME_STATE_MANUAL] = KEY_ACTION_NONE,
+  [GAME_STATE_STATS] = KEY_ACTION_NONE,
+  [GAME_STATE_QUIT] = KEY_ACTION_NONE,
+};
+
+
+struct KeyBindingEntry {
+  enum GameState game_state;
+  int key;
+  enum KeyAction action;
+};
+
+
+const struct KeyBindingEntry g_key_binding_defaults[] = {
+  {GAME_STATE_START_MENU, KEY_UP, KEY_ACTION_MOVE_UP},
+  {GAME_STATE_START_MENU, KEY_DOWN, KEY_ACTION_MOVE_DOWN},
+  {GAME_STATE_IN_GAME, KEY_UP, KEY_ACTION_MOVE_UP},
+  {GAME_STATE_IN_GAME, KEY_DOWN, KEY_ACTION_MOVE_DOWN},
+  {GAME_STATE_IN_GAME, KEY_LEFT, KEY_ACTION_MOVE_LEFT},
+  {GAME_STATE_IN_GAME, KEY_RIGHT, KEY_ACTION_MOVE_RIGHT},
+  {GAME_STATE_IN_GAME, ' ', KEY_ACTION_PLAY},
+  {GAME_STATE_IN_GAME, 'c', KEY_ACTION_CHORD},
+  {GAME_STATE_IN_GAME, 'o', KEY_ACTION_OK_MARKER},
+  {GAME_STATE_IN_GAME, 'x', KEY_ACTION_MINE_MARKER},
+  {GAME_STATE_IN_GAME, 'm', KEY_ACTION_TOGGLE_MINIMAP},
+  {GAME_STATE_IN_GAME, 'a', KEY_ACTION_TOGGLE_ANIMATION},
+  {GAME_STATE_IN_GAME, 'p', KEY_ACTION_TOGGLE_HUD},
+  {GAME_STATE_IN_GAME, 'f', KEY_ACTION_NEXT_FRONTIER},
+  {GAME_STATE_IN_GAME, 'F', KEY_ACTION_PREVIOUS_FRONTIER},
+  {GAME_STATE_IN_GAME, 'n', KEY_ACTION_NEXT_UNSATISFIED},
+  {GAME_STATE_IN_GAME, 'N', KEY_ACTION_PREVIOUS_UNSATISFIED},
+  {GAME_STATE_MENU, KEY_UP, KEY_ACTION_MOVE_UP},
+  {GAME_STATE_MENU, KEY_DOWN, KEY_ACTION_MOVE_DOWN},
+  {GAME_STATE_MANUAL, KEY_UP, KEY_ACTION_MOVE_UP},
+  {GAME_STATE_MANUAL, KEY_DOWN, KEY_ACTION_MOVE_DOWN},
+  {GAME_STATE_STATS, KEY_LEFT, KEY_ACTION_MOVE_LEFT},
+  {GAME_STATE_STATS, KEY_RIGHT, KEY_ACTION_MOVE_RIGHT},
+};
+
+
+void key_binding_bind(
+    struct KeyBinding* key_binding,
+    enum GameState game_state,
+    int key,
+    enum KeyAction action
+) {
+  if (game_state < 0 || game_state >= GAME_STATE_MAX) return;
+  if (key < 0 || key >= KEY_BINDING_KEY_COUNT) return;
+  key_binding->actions[game_state][key] = action;
+}
+
+
+void key_binding_init(struct KeyBinding* key_binding) {
+  for (int state = 0; state < GAME_STATE_MAX; state++) {
+    for (int key = 0; key < KEY_BINDING_KEY_COUNT; key++) {
+      key_binding->actions[state][key] = g_key_binding_default_actions[state];
+    }
+    // Escape goes back to the start menu from everywhere.
+    key_binding->actions[state][KEY_ESC] = KEY_ACTION_START_MENU;
+  }
+  for (int i = 0; i < array_size(g_key_binding_defaults); i++) {
+    const struct KeyBindingEntry* entry = &g_key_binding_defaults[i];
+    key_binding_bind(key_binding, entry->game_state, entry->key, entry->action);
+  }
+  for (int key = '0'; key <= '9'; key++) {
+    key_binding_bind(key_binding, GAME_STATE_IN_GAME, key, KEY_ACTION_COUNT);
+  }
+}
+
+
+enum KeyAction key_binding_get_action(
+    const struct KeyBinding* key_binding,
+    enum GameState game_state,
+    int key
+) {
+  if (key < 0 || key >= KEY_BINDING_KEY_COUNT) return KEY_ACTION_NONE;
+  return key_binding->actions[game_state][key];
+}
+
+
+const char* key_binding_get_key_name(int key) {
+  if (key < 0 || key >= KEY_BINDING_KEY_COUNT) return NULL;
+  return g_key_binding_key_names[key];
+}
+
+
+int key_binding_parse_key(const char* text) {
+  if (text[0] != '\0' && text[1] == '\0') return (unsigned char)text[0];
+  for (int key = 0; key < KEY_BINDING_KEY_COUNT; key++) {
+    const char* name = g_key_binding_key_names[key];
+    if (name != NULL && strcmp(name, text) == 0) return key;
+  }
+  return -1;
+}
+
+
+int key_binding_parse_name(const char* text, const char** names, int count) {
+  for (int i = 0; i < count; i++) {
+    if (names[i] != NULL && strcmp(names[i], text) == 0) return i;
+  }
+  return -1;
+}
+
+
+/**
+ * Reads bindings from a text file with one binding per line:
+ *   <state> <key> <action>
+ * e.g. "in_game h move_left" or "menu KEY_NEWLINE select". Lines starting
+ * with '#' are comments. Invalid lines are logged and skipped.
+ */
+bool key_binding_load(struct KeyBinding* key_binding, const char* path) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) return false;
+
+  char line[KEY_BINDING_LINE_MAX];
+  int line_number = 0;
+  while (fgets(line, sizeof(line), file) != NULL) {
+    line_number++;
+    char state_text[KEY_BINDING_TOKEN_MAX];
+    char key_text[KEY_BINDING_TOKEN_MAX];
+    char action_text[KEY_BINDING_TOKEN_MAX];
+    int token_count = sscanf(line, "%31s %31s %31s", state_text, key_text, action_text);
+    if (token_count <= 0 || state_text[0] == '#') continue;
+    if (token_count != 3) {
+      log_error_f("%s:%d: expected '<state> <key> <action>'", path, line_number);
+      continue;
+    }
+    int game_state = key_binding_parse_name(
+        state_text,
+        g_key_binding_state_names,
+        GAME_STATE_MAX
+    );
+    int key = key_binding_parse_key(key_text);
+    int action = key_binding_parse_name(
+        action_text,
+        g_key_binding_action_names,
+        KEY_ACTION_MAX
+    );
+    if (game_state < 0 || key < 0 || action < 0) {
+      log_error_f("%s:%d: invalid binding: %s", path, line_number, line);
+      continue;
+    }
+    key_binding_bind(key_binding, game_state, key, action);
+  }
+
+  fclose(file);
+  log_info_f("Key bindings loaded from %s", path);
+  return true;
+}
+
+
+void key_binding_load_user_file(struct KeyBinding* key_binding) {
+  const char* path = getenv(KEY_BINDING_FILE_ENV);
+  if (path != NULL) {
+    if (!key_binding_load(key_binding, path)) {
+      log_error_f("Failed to open key bindings %s: %s", path, strerror(errno));
+    }
+    return;
+  }
+  const char* home = getenv("HOME");
+  if (home == NULL) return;
+  char home_path[KEY_BINDING_LINE_MAX];
+  snprintf(home_path, sizeof(home_path), "%s/%s", home, KEY_BINDING_FILE_NAME);
+  key_binding_load(key_binding, home_path);
+}
@@ -0,0 +1,67 @@
+#ifndef KEY_BINDING_H
+#define KEY_BINDING_H
+
+
+#include <curses.h>
+#include <stdbool.h>
+#include "game.h"
+
+
+#define KEY_ESC 27
+#define KEY_BINDING_KEY_COUNT (KEY_MAX + 1)
+#define KEY_BINDING_FILE_ENV "MINESWEEPER_KEYS"
+#define KEY_BINDING_FILE_NAME ".minesweeper_keys"
+
+
+enum KeyAction {
+  KEY_ACTION_NONE,
+  KEY_ACTION_MOVE_UP,
+  KEY_ACTION_MOVE_DOWN,
+  KEY_ACTION_MOVE_LEFT,
+  KEY_ACTION_MOVE_RIGHT,
+  KEY_ACTION_PLAY,
+  KEY_ACTION_CHORD,
+  KEY_ACTION_OK_MARKER,
+  KEY_ACTION_MINE_MARKER,
+  KEY_ACTION_TOGGLE_MINIMAP,
+  KEY_ACTION_TOGGLE_ANIMATION,
+  KEY_ACTION_TOGGLE_HUD,
+  KEY_ACTION_SELECT,
+  KEY_ACTION_START_MENU,
+  KEY_ACTION_COUNT,
+  KEY_ACTION_NEXT_FRONTIER,
+  KEY_ACTION_PREVIOUS_FRONTIER,
+  KEY_ACTION_NEXT_UNSATISFIED,
+  KEY_ACTION_PREVIOUS_UNSATISFIED,
+  KEY_ACTION_MAX
+};
+
+
+/**
+ * One action per key and per game state. Keys that are not bound explicitly
+ * get the default action of their state, so a key press is a single lookup.
+ */
+struct KeyBinding {
+  unsigned char actions[GAME_STATE_MAX][KEY_BINDING_KEY_COUNT];
+};
+
+
+void key_binding_init(struct KeyBinding* key_binding);
+void key_binding_bind(
+    struct KeyBinding* key_binding,
+    enum GameState game_state,
+    int key,
+    enum KeyAction action
+);
+bool key_binding_load(struct KeyBinding* key_binding, const char* path);
+void key_binding_load_user_file(struct KeyBinding* key_binding);
+enum KeyAction key_binding_get_action(
+    const struct KeyBinding* key_binding,
+    enum GameState game_state,
+    int key
+);
+const char* key_binding_get_key_name(int key);
+int key_binding_parse_key(const char* text);
+
+
+#endif
@@ -1,9 +1,326 @@
 #include "log.h"
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+#define LOG_BATCH_SIZE (64 * 1024)
+// Time given to records to pile up before a batch is written.
+#define LOG_BATCH_DELAY_NS 10000000L
+// Backlog that cuts the batch delay short so the ring does not fill up.
+#define LOG_HIGH_WATER (LOG_RING_SIZE / 2)
+
+
+_Static_assert((LOG_RING_SIZE & LOG_RING_MASK) == 0, "LOG_RING_SIZE must be a power of 2.");
+
+
+/**
+ * One formatted log line. `sequence` tells whose turn it is: producers may
+ * fill the record when it equals their position, the writer thread may read
+ * it when it equals that position + 1.
+ */
+struct LogRecord {
+  atomic_size_t sequence;
+  int length;
+  char text[LOG_RECORD_SIZE];
+};
+
+
+enum LogWriterState {
+  // Writing records, producers never wake it up.
+  LOG_WRITER_STATE_RUNNING,
+  // The ring is empty, the first record wakes it up.
+  LOG_WRITER_STATE_IDLE,
+  // Waiting for a batch to pile up, a backlog over the high water wakes it up.
+  LOG_WRITER_STATE_BATCHING
+};
+
+
+/**
+ * Bounded multi producer, single consumer ring of records. Producers only
+ * format and publish; a background thread writes the records in batches.
+ * When the ring is full records are dropped rather than blocking the caller.
+ */
+struct Log {
+  struct LogRecord records[LOG_RING_SIZE];
+  atomic_size_t write_position;
+  atomic_size_t read_position;
+  atomic_long dropped;
+  atomic_int writer_state;
+  atomic_bool stop;
+  sem_t wakeup;
+  pthread_t thread;
+  // Read by producers while log_close clears it.
+  atomic_bool running;
+  char batch[LOG_BATCH_SIZE];
+};
+
+
+FILE* g_debug_file = NULL;
+struct Log g_log;
+
+
+const char* g_log_level_names[] = {
+  "INFO",
+  "ERROR",
+  "FATAL"
+};
+
+
+void log_write_fd(const char* text, int length) {
+  int fd = g_debug_file != NULL ? fileno(g_debug_file) : STDERR_FILENO;
+  int written = 0;
+  while (written < length) {
+    ssize_t result = write(fd, text + written, length - written);
+    if (result < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+    written += result;
+  }
+}
+
+
+int log_format(
+    char* text,
+    int size,
+    int level,
+    const char* file,
+    int line,
+    const char* pattern,
+    va_list arguments
+) {
+  int length = snprintf(text, size, "[%s][%s:%d] ", g_log_level_names[level], file, line);
+  if (length < size - 1) {
+    length += vsnprintf(text + length, size - length, pattern, arguments);
+  }
+  // Truncated records still end with a line feed.
+  if (length > size - 2) length = size - 2;
+  text[length++] = '\n';
+  return length;
+}
+
+
+/**
+ * Write every published record, in one write per batch.
+ * Returns the number of records written.
+ */
+int log_drain(struct Log* log) {
+  int count = 0;
+  int batch_size = 0;
+  size_t position = atomic_load_explicit(&log->read_position, memory_order_relaxed);
+
+  long dropped = atomic_exchange(&log->dropped, 0);
+  if (dropped > 0) {
+    batch_size += snprintf(log->batch, LOG_RECORD_SIZE, "[ERROR] %ld log records dropped\n", dropped);
+  }
+
+  while (true) {
+    struct LogRecord* record = &log->records[position & LOG_RING_MASK];
+    size_t sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+    if (sequence != position + 1) break;
+    if (batch_size + record->length > LOG_BATCH_SIZE) {
+      log_write_fd(log->batch, batch_size);
+      batch_size = 0;
+    }
+    memcpy(log->batch + batch_size, record->text, record->length);
+    batch_size += record->length;
+    atomic_store_explicit(&record->sequence, position + LOG_RING_SIZE, memory_order_release);
+    position++;
+    atomic_store_explicit(&log->read_position, position, memory_order_release);
+    count++;
+  }
+
+  if (batch_size > 0) log_write_fd(log->batch, batch_size);
+  return count;
+}
+
+
+bool log_is_empty(struct Log* log) {
+  size_t position = atomic_load(&log->read_position);
+  struct LogRecord* record = &log->records[position & LOG_RING_MASK];
+  return atomic_load(&record->sequence) != position + 1;
+}
+
+
+void log_wait_batch(struct Log* log) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_nsec += LOG_BATCH_DELAY_NS;
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+  atomic_store(&log->writer_state, LOG_WRITER_STATE_BATCHING);
+  while (sem_timedwait(&log->wakeup, &deadline) < 0 && errno == EINTR);
+  atomic_store(&log->writer_state, LOG_WRITER_STATE_RUNNING);
+}
+
+
+void* log_thread_run(void* data) {
+  struct Log* log = data;
+  while (true) {
+    log_drain(log);
+    if (atomic_load(&log->stop)) break;
+    // Producers only wake an idle writer, so check again after going idle
+    // in case a record was published in between.
+    atomic_store(&log->writer_state, LOG_WRITER_STATE_IDLE);
+    // Pairs with the fence in log_write: either this sees the record or
+    // its producer sees IDLE and posts the semaphore.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (log_is_empty(log) && !atomic_load(&log->stop)) {
+      while (sem_wait(&log->wakeup) < 0 && errno == EINTR);
+    }
+    atomic_store(&log->writer_state, LOG_WRITER_STATE_RUNNING);
+    if (atomic_load(&log->stop)) continue;
+    log_wait_batch(log);
+  }
+  log_drain(log);
+  return NULL;
+}
+
+
+void log_wake_up(struct Log* log) {
+  int state = atomic_load(&log->writer_state);
+  if (state == LOG_WRITER_STATE_RUNNING) return;
+  if (state == LOG_WRITER_STATE_BATCHING && log_get_backlog() < LOG_HIGH_WATER) return;
+  if (atomic_compare_exchange_strong(&log->writer_state, &state, LOG_WRITER_STATE_RUNNING)) {
+    sem_post(&log->wakeup);
+  }
+}
 
 
 void log_init() {
+  struct Log* log = &g_log;
   g_debug_file = fopen(DEBUG_FILE, "w+");
   if (g_debug_file == NULL) {
     log_fatal_f("fopen(\"%s\") failed (%d): %s\n", DEBUG_FILE, errno, strerror(errno));
   }
+
+  for (size_t i = 0; i < LOG_RING_SIZE; i++) {
+    atomic_init(&log->records[i].sequence, i);
+  }
+  atomic_init(&log->write_position, 0);
+  atomic_init(&log->read_position, 0);
+  atomic_init(&log->dropped, 0);
+  atomic_init(&log->writer_state, LOG_WRITER_STATE_RUNNING);
+  atomic_init(&log->stop, false);
+  if (sem_init(&log->wakeup, 0, 0) < 0) {
+    log_fatal_f("sem_init() failed (%d): %s\n", errno, strerror(errno));
+  }
+  // The writer thread must not take signals meant for the event loop.
+  sigset_t all_signals;
+  sigset_t previous_signals;
+  sigfillset(&all_signals);
+  pthread_sigmask(SIG_SETMASK, &all_signals, &previous_signals);
+  int error = pthread_create(&log->thread, NULL, log_thread_run, log);
+  pthread_sigmask(SIG_SETMASK, &previous_signals, NULL);
+  if (error != 0) {
+    log_fatal_f("pthread_create() failed (%d): %s\n", error, strerror(error));
+  }
+  atomic_store(&log->running, true);
+  atexit(log_close);
+}
+
+
+/**
+ * Stop the writer thread once every pending record is written.
+ * Later logs are written synchronously.
+ */
+void log_close() {
+  struct Log* log = &g_log;
+  if (!atomic_exchange(&log->running, false)) return;
+  atomic_store(&log->stop, true);
+  sem_post(&log->wakeup);
+  pthread_join(log->thread, NULL);
+  sem_destroy(&log->wakeup);
+}
+
+
+void log_write(int level, const char* file, int line, const char* pattern, ...) {
+  struct Log* log = &g_log;
+  va_list arguments;
+  va_start(arguments, pattern);
+
+  if (!atomic_load(&log->running)) {
+    char text[LOG_RECORD_SIZE];
+    int length = log_format(text, sizeof(text), level, file, line, pattern, arguments);
+    va_end(arguments);
+    log_write_fd(text, length);
+    return;
+  }
+
+  // Claim a record, see `struct LogRecord` for the protocol.
+  size_t position = atomic_load_explicit(&log->write_position, memory_order_relaxed);
+  struct LogRecord* record;
+  while (true) {
+    record = &log->records[position & LOG_RING_MASK];
+    size_t sequence = atomic_load_explicit(&record->sequence, memory_order_acquire);
+    intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+    if (difference == 0) {
+      if (atomic_compare_exchange_weak_explicit(
+            &log->write_position,
+            &position,
+            position + 1,
+            memory_order_relaxed,
+            memory_order_relaxed
+      )) break;
+    } else if (difference < 0) {
+      atomic_fetch_add(&log->dropped, 1);
+      va_end(arguments);
+      log_wake_up(log);
+      return;
+    } else {
+      position = atomic_load_explicit(&log->write_position, memory_order_relaxed);
+    }
+  }
+
+  record->length = log_format(
+      record->text,
+      LOG_RECORD_SIZE,
+      level,
+      file,
+      line,
+      pattern,
+      arguments
+  );
+  va_end(arguments);
+  atomic_store_explicit(&record->sequence, position + 1, memory_order_release);
+  // A release store may pass the load of `writer_state` that follows.
+  atomic_thread_fence(memory_order_seq_cst);
+  log_wake_up(log);
+}
+
+
+/**
+ * Write pending records and this one before the caller exits.
+ */
+void log_write_fatal(const char* file, int line, const char* pattern, ...) {
+  log_close();
+  char text[LOG_RECORD_SIZE];
+  va_list arguments;
+  va_start(arguments, pattern);
+  int length = log_format(text, sizeof(text), LOG_LEVEL_FATAL, file, line, pattern, arguments);
+  va_end(arguments);
+  log_write_fd(text, length);
+}
+
+
+/**
+ * Records published but not written yet.
+ */
+long log_get_backlog() {
+  return atomic_load(&g_log.write_position) - atomic_load(&g_log.read_position);
+}
+
+
+long log_get_dropped() {
+  return atomic_load(&g_log.dropped);
 }
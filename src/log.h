@@ -9,61 +9,93 @@
 
 
 #define DEBUG_FILE "/tmp/minesweeper.log"
-struct _IO_FILE* g_debug_file;
 
+#define LOG_LEVEL_INFO 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_FATAL 2
+
+// Levels below this one are compiled out, e.g. `make CFLAGS=-DLOG_LEVEL=1`.
+// Their arguments are still type checked but never evaluated.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Number of records the ring buffer holds, must be a power of 2.
+#define LOG_RING_SIZE 4096
+// Longest record, longer ones are truncated.
+#define LOG_RECORD_SIZE 256
+
+
+extern FILE* g_debug_file;
+
+
+#if LOG_LEVEL <= LOG_LEVEL_INFO
 
 #define log_info(text) { \
-  fprintf(g_debug_file, "[INFO][%s:%d] ", __FILE__, __LINE__); \
-  fprintf(g_debug_file, text); \
-  fprintf(g_debug_file, "\n"); \
-  fflush(g_debug_file); \
+  log_write(LOG_LEVEL_INFO, __FILE__, __LINE__, text); \
 }
 
+#define log_info_f(pattern, ...) { \
+  log_write(LOG_LEVEL_INFO, __FILE__, __LINE__, pattern, __VA_ARGS__); \
+}
+
+#else
+
+#define log_info(text) { \
+  if (0) log_write(LOG_LEVEL_INFO, __FILE__, __LINE__, text); \
+}
 
 #define log_info_f(pattern, ...) { \
-  fprintf(g_debug_file, "[INFO][%s:%d] ", __FILE__, __LINE__); \
-  fprintf(g_debug_file, pattern, __VA_ARGS__); \
-  fprintf(g_debug_file, "\n"); \
-  fflush(g_debug_file); \
+  if (0) log_write(LOG_LEVEL_INFO, __FILE__, __LINE__, pattern, __VA_ARGS__); \
 }
 
+#endif
+
+
+#if LOG_LEVEL <= LOG_LEVEL_ERROR
 
 #define log_error(text) { \
-  fprintf(g_debug_file, "[ERROR][%s:%d] ", __FILE__, __LINE__); \
-  fprintf(g_debug_file, text); \
-  fprintf(g_debug_file, "\n"); \
-  fflush(g_debug_file); \
+  log_write(LOG_LEVEL_ERROR, __FILE__, __LINE__, text); \
+}
+
+#define log_error_f(pattern, ...) { \
+  log_write(LOG_LEVEL_ERROR, __FILE__, __LINE__, pattern, __VA_ARGS__); \
 }
 
+#else
+
+#define log_error(text) { \
+  if (0) log_write(LOG_LEVEL_ERROR, __FILE__, __LINE__, text); \
+}
 
 #define log_error_f(pattern, ...) { \
-  fprintf(g_debug_file, "[ERROR][%s:%d] ", __FILE__, __LINE__); \
-  fprintf(g_debug_file, pattern, __VA_ARGS__); \
-  fprintf(g_debug_file, "\n"); \
-  fflush(g_debug_file); \
+  if (0) log_write(LOG_LEVEL_ERROR, __FILE__, __LINE__, pattern, __VA_ARGS__); \
 }
 
+#endif
+
 
+// Fatal logs are never filtered and reach the file before exiting.
 #define log_fatal(text) { \
-  fprintf(g_debug_file, "[FATAL][%s:%d] ", __FILE__, __LINE__); \
-  fprintf(g_debug_file, text); \
-  fprintf(g_debug_file, "\n"); \
-  fflush(g_debug_file); \
+  log_write_fatal(__FILE__, __LINE__, text); \
   exit(1); \
 }
 
 
 #define log_fatal_f(pattern, ...) { \
-  fprintf(g_debug_file, "[FATAL][%s:%d] ", __FILE__, __LINE__); \
-  fprintf(g_debug_file, pattern, __VA_ARGS__); \
-  fprintf(g_debug_file, "\n"); \
-  fflush(g_debug_file); \
+  log_write_fatal(__FILE__, __LINE__, pattern, __VA_ARGS__); \
   exit(1); \
 }
 
 
 void log_init();
+void log_close();
+void log_write(int level, const char* file, int line, const char* pattern, ...)
+  __attribute__((format(printf, 4, 5)));
+void log_write_fatal(const char* file, int line, const char* pattern, ...)
+  __attribute__((format(printf, 3, 4)));
+long log_get_backlog();
+long log_get_dropped();
 
 
 #endif
-
@@ -3,6 +3,16 @@
 #include "render.h"
 #include "ui.h"
 #include "consts.h"
+#include "render_ncurses.h"
+#include "render_ansi.h"
+#include "bench.h"
+#include "event_loop.h"
+#include "command_stream.h"
+#include "trace.h"
+#include "difftest.h"
+#include "spectator.h"
+#include "shared_game.h"
+#include "export.h"
 
 
 /********************************************************************************
@@ -20,66 +30,225 @@ void debug_init() {
 #endif
 
 
+struct RenderNcurses render_ncurses;
+struct RenderAnsi render_ansi;
+struct RenderBackend render_backend;
+struct EventLoop event_loop;
 struct UI ui;
 struct Game game;
+struct CommandStream command_stream;
+struct Spectator spectator;
+struct SharedGame shared_game;
 
 
 void main_update_game(struct Game* game) {
+  trace_begin(TRACE_NAME_UPDATE_GAME);
   if (game->game_state == GAME_STATE_IN_GAME) {
     if (game_board_is_lost(&game->game_board)) {
       game_set_game_state(game, GAME_STATE_GAME_OVER);
+      stats_record_game(&ui.stats, game, metrics_now_ns() / 1000000);
     } else if (game_board_is_win(&game->game_board)) {
       game_set_game_state(game, GAME_STATE_GAME_WON);
+      stats_record_game(&ui.stats, game, metrics_now_ns() / 1000000);
     }
   }
+  trace_end(TRACE_NAME_UPDATE_GAME);
 }
 
 
-int main() {
+void main_handle_signal(int signal_number) {
+  switch (signal_number) {
+    case SIGWINCH:
+      render_backend_resize(&render_backend);
+      ui_layout(&ui);
+      break;
+    case SIGINT:
+    case SIGTERM:
+      game_set_game_state(&game, GAME_STATE_QUIT);
+      break;
+  }
+}
+
+
+/**
+ * Handle every key available without blocking.
+ */
+void main_handle_input() {
+  int input;
+  metrics_input_received(&ui.metrics);
+  while ((input = render_backend_read_key(&render_backend, 0)) != RENDER_BACKEND_NO_KEY) {
+    trace_begin(TRACE_NAME_INPUT_UPDATE);
+    input_update(&game, &ui, input);
+    trace_end(TRACE_NAME_INPUT_UPDATE);
+    game_print_state(game.game_state);
+    if (game.game_state == GAME_STATE_QUIT) return;
+    main_update_game(&game);
+  }
+}
+
+
+int main(int argc, char** argv) {
   log_init();
+
+  if (argc > 2 && strcmp(argv[1], "--trace-to-json") == 0) {
+    FILE* trace_file = fopen(argv[2], "r");
+    if (trace_file == NULL) {
+      log_fatal_f("fopen(\"%s\") failed (%d): %s\n", argv[2], errno, strerror(errno));
+    }
+    bool is_converted = trace_convert_to_json(trace_file, stdout);
+    fclose(trace_file);
+    return is_converted ? 0 : 1;
+  }
+  trace_init();
+  if (argc > 1 && strcmp(argv[1], "--bench-render") == 0) {
+    bench_render(argc > 2 ? atoi(argv[2]) : BENCH_RENDER_FRAMES);
+    return 0;
+  }
+  if (argc > 1 && strcmp(argv[1], "--simulate") == 0) {
+    bench_simulate(argc > 2 ? atoi(argv[2]) : BENCH_SIMULATE_GAMES);
+    return 0;
+  }
+  if (argc > 1 && strcmp(argv[1], "--difftest") == 0) {
+    bool is_same = difftest_run(
+        argc > 2 ? atoi(argv[2]) : DIFFTEST_BOARDS,
+        argc > 3 ? strtoul(argv[3], NULL, 10) : 0,
+        argc > 4 ? atoi(argv[4]) : 0
+    );
+    return is_same ? 0 : 1;
+  }
+  if (argc > 1 && strcmp(argv[1], "--export") == 0) {
+    // --export [--binary] <path> <width> <height> [count] [first_seed] [density]
+    bool binary = argc > 2 && strcmp(argv[2], "--binary") == 0;
+    int argument = binary ? 3 : 2;
+    if (argc < argument + 3) {
+      fprintf(stderr, "Usage: %s --export [--binary] <path> <width> <height> [count] [first_seed] [density]\n", argv[0]);
+      return 1;
+    }
+    bool is_exported = export_run(
+        argv[argument],
+        binary,
+        atoi(argv[argument + 1]),
+        atol(argv[argument + 2]),
+        argc > argument + 3 ? atoi(argv[argument + 3]) : 1,
+        argc > argument + 4 ? strtoul(argv[argument + 4], NULL, 10) : 0,
+        argc > argument + 5 ? atoi(argv[argument + 5]) : EXPORT_DENSITY
+    );
+    return is_exported ? 0 : 1;
+  }
+  if (argc > 2 && strcmp(argv[1], "--read-shared") == 0) {
+    return shared_game_print(argv[2], stdout) ? 0 : 1;
+  }
+  if (argc > 1 && strcmp(argv[1], "--stats") == 0) {
+    stats_init(&ui.stats);
+    if (argc > 2) {
+      stats_open(&ui.stats, argv[2]);
+    } else {
+      stats_open_user_file(&ui.stats);
+    }
+    stats_print(&ui.stats, stdout);
+    stats_close(&ui.stats);
+    return 0;
+  }
+  if (argc > 1 && strcmp(argv[1], "--render-frame") == 0) {
+    bench_render_frame(stdout);
+    return 0;
+  }
+  if (argc > 1 && strcmp(argv[1], "--pipe") == 0) {
+    bool binary = argc > 2 && strcmp(argv[2], "--binary") == 0;
+    command_stream_init(&command_stream, STDIN_FILENO, STDOUT_FILENO, binary);
+    command_stream_run(&command_stream);
+    command_stream_close(&command_stream);
+    return 0;
+  }
+
   srand(time(NULL));
   game_init_medium_mode(&game);
-  ui_init(&ui);
+  event_loop_init(&event_loop);
+  if (argc > 1 && strcmp(argv[1], "--ansi") == 0) {
+    render_ansi_init(&render_backend, &render_ansi);
+  } else {
+    render_ncurses_init(&render_backend, &render_ncurses);
+  }
+  ui_init(&ui, &render_backend);
+  key_binding_load_user_file(&ui.key_binding);
+  recorder_open_user_file(&ui.recorder);
+  stats_open_user_file(&ui.stats);
+  spectator_init(&spectator);
+  spectator_open_user_socket(&spectator);
+  event_loop_watch(&event_loop, EVENT_LOOP_SOURCE_SPECTATOR, spectator.listen_fd);
+  shared_game_init(&shared_game);
+  shared_game_open_user_segment(&shared_game);
 
 
 #if DEBUG_ENABLE_TEST
   debug_init();
 #endif
 
-  // Loop to track cursor position
-  while (true) {
-    log_info("LOOP BEGIN");
-    if (DEBUG_GAME_BOARD_SHOW_ALL) game_board_show_all(&game.game_board);
-
-    struct Terminal* terminal = &ui.terminal;
-    terminal_init(terminal);
-    log_info_f("terminal={width:%d, height:%d}", terminal->width, terminal->height);
-    struct Vector center = terminal_center(terminal);
-
-    if (terminal->height < TERMINAL_MIN_HEIGHT) {
-      log_info("Terminal height is less than the minimum allowed.");
-      erase();
-      addstr(
-          "Terminal height is less than the minimum allowed.\n"
-          "Please resize the terminal.\n"
-      );
-      refresh();
-      getch();  // Wait for resize.
-      continue;
+  // Nothing runs between events, the timer is only armed while animating.
+  bool needs_render = true;
+  while (game.game_state != GAME_STATE_QUIT) {
+    if (needs_render) {
+      log_info("RENDER");
+      if (DEBUG_GAME_BOARD_SHOW_ALL) game_board_show_all(&game.game_board, &game.delta);
+      // The render clears the delta.
+      spectator_publish(&spectator, &game.game_board, &game.delta);
+      shared_game_publish(&shared_game, &game);
+      // Bytes are counted around the timed frame, not inside it.
+      render_backend_begin_byte_count(&render_backend);
+      long render_start_ns = metrics_now_ns();
+      trace_begin(TRACE_NAME_RENDER);
+      render(&ui, &game);
+      trace_end(TRACE_NAME_RENDER);
+      long render_ns = metrics_now_ns() - render_start_ns;
+      render_backend_end_byte_count(&render_backend);
+      metrics_frame_rendered(&ui.metrics, render_ns, render_backend.frame_stats.bytes);
     }
-
-    render(center, &ui, &game);
-
-    input_update(&game, &ui);
-    game_print_state(game.game_state);
-    if (game.game_state == GAME_STATE_QUIT) {
-      break;
+    spectator_flush(&spectator, &game.game_board);
+    int timeout = reveal_animation_get_timeout(&ui.reveal_animation);
+    int spectator_timeout = spectator_get_timeout(&spectator);
+    if (timeout < 0 || (spectator_timeout >= 0 && spectator_timeout < timeout)) {
+      timeout = spectator_timeout;
+    }
+    event_loop_set_timer(&event_loop, timeout);
+
+    trace_begin(TRACE_NAME_WAIT);
+    int events = event_loop_wait(&event_loop);
+    trace_end(TRACE_NAME_WAIT);
+    needs_render = false;
+    if (events & EVENT_LOOP_SIGNAL) {
+      int signal_number;
+      while ((signal_number = event_loop_read_signal(&event_loop)) != 0) {
+        main_handle_signal(signal_number);
+      }
+      needs_render = true;
+    }
+    if (events & EVENT_LOOP_INPUT) {
+      main_handle_input();
+      needs_render = true;
+    }
+    if (events & EVENT_LOOP_SPECTATOR) spectator_accept(&spectator);
+    // The timer also fires to retry spectators.
+    if (
+      (events & EVENT_LOOP_TIMER)
+      && !needs_render
+      && reveal_animation_is_running(&ui.reveal_animation)
+    ) {
+      render_backend_begin_byte_count(&render_backend);
+      trace_begin(TRACE_NAME_RENDER_ANIMATION);
+      render_reveal_animation(&ui, &game);
+      trace_end(TRACE_NAME_RENDER_ANIMATION);
+      render_backend_end_byte_count(&render_backend);
     }
-
-    main_update_game(&game);
   }
 
-  endwin();  // End ncurses.
+  recorder_close(&ui.recorder);
+  stats_close(&ui.stats);
+  spectator_close(&spectator);
+  shared_game_close(&shared_game);
+  render_backend_close(&render_backend);
+  event_loop_close(&event_loop);
+  // After the terminal is restored, so the summary stays on screen.
+  metrics_print_summary(&ui.metrics, stderr);
   return 0;
 }
 
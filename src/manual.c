@@ -17,6 +17,15 @@ const char* const manual_text[] = {
   "ESC      Show Menu.          ",
   "X        Set bomb marker.    ",
   "SPACE    Reveal cell.        ",
+  "C        Reveal around number",
+  "M        Toggle minimap.     ",
+  "A        Toggle animations.  ",
+  "P        Toggle perf overlay.",
+  "F        Next frontier cell. ",
+  "SHIFT F  Previous frontier.  ",
+  "N        Next unsolved cell. ",
+  "SHIFT N  Previous unsolved.  ",
+  "0-9      Repeat next move.   ",
   "UP ARROW Move cursor up.     ",
   "UP DOWN  Move cursor down.   ",
   "UP LEFT  Move cursor left.   ",
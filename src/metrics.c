@@ -0,0 +1,103 @@
+#include "metrics.h"
+#include "log.h"
+#include "util.h"
+#include <time.h>
+
+
+struct MetricInfo {
+  const char* label;
+  // Values are recorded in this many base units per displayed unit.
+  long scale;
+};
+
+
+const struct MetricInfo g_metric_infos[METRIC_ID_MAX] = {
+  [METRIC_ID_FRAME_TIME] = {"frame us", 1000},
+  [METRIC_ID_INPUT_LATENCY] = {"input us", 1000},
+  [METRIC_ID_CELLS_REVEALED] = {"revealed", 1},
+  [METRIC_ID_FRAME_BYTES] = {"bytes", 1},
+  [METRIC_ID_LOG_BACKLOG] = {"log", 1},
+};
+
+
+void metrics_init(struct Metrics* metrics) {
+  for (int id = 0; id < METRIC_ID_MAX; id++) {
+    histogram_init(&metrics->histograms[id]);
+    metrics->last[id] = 0;
+  }
+  metrics->input_time_ns = 0;
+  metrics->enable = false;
+}
+
+
+long metrics_now_ns() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000000L + now.tv_nsec;
+}
+
+
+void metrics_record(struct Metrics* metrics, enum MetricId id, long value) {
+  metrics->last[id] = value;
+  histogram_record(&metrics->histograms[id], value);
+}
+
+
+void metrics_input_received(struct Metrics* metrics) {
+  if (metrics->input_time_ns == 0) metrics->input_time_ns = metrics_now_ns();
+}
+
+
+/**
+ * Record a full frame. The input latency goes from the oldest input the
+ * frame shows to the end of the frame.
+ */
+void metrics_frame_rendered(struct Metrics* metrics, long frame_time_ns, long frame_bytes) {
+  metrics_record(metrics, METRIC_ID_FRAME_TIME, frame_time_ns);
+  metrics_record(metrics, METRIC_ID_FRAME_BYTES, frame_bytes);
+  metrics_record(metrics, METRIC_ID_LOG_BACKLOG, log_get_backlog());
+  if (metrics->input_time_ns != 0) {
+    metrics_record(metrics, METRIC_ID_INPUT_LATENCY, metrics_now_ns() - metrics->input_time_ns);
+    metrics->input_time_ns = 0;
+  }
+}
+
+
+const char* metrics_get_label(enum MetricId id) {
+  return g_metric_infos[id].label;
+}
+
+
+long metrics_get_display_value(enum MetricId id, long value) {
+  return value / g_metric_infos[id].scale;
+}
+
+
+void metrics_toggle(struct Metrics* metrics) {
+  metrics->enable = !metrics->enable;
+  log_info_f("metrics_toggle(metrics): enable=%s", boolean_as_string(metrics->enable));
+}
+
+
+/**
+ * Printed rather than logged, so release builds that compile out the info
+ * logs still report the outliers.
+ */
+void metrics_print_summary(struct Metrics* metrics, FILE* file) {
+  fprintf(file, "Metrics summary: count min p50 p90 p99 p99.9 max\n");
+  for (int id = 0; id < METRIC_ID_MAX; id++) {
+    struct Histogram* histogram = &metrics->histograms[id];
+    fprintf(
+        file,
+        "  %-8s %ld %ld %ld %ld %ld %ld %ld\n",
+        metrics_get_label(id),
+        histogram->count,
+        metrics_get_display_value(id, histogram->min),
+        metrics_get_display_value(id, histogram_get_percentile(histogram, 50)),
+        metrics_get_display_value(id, histogram_get_percentile(histogram, 90)),
+        metrics_get_display_value(id, histogram_get_percentile(histogram, 99)),
+        metrics_get_display_value(id, histogram_get_percentile(histogram, 99.9)),
+        metrics_get_display_value(id, histogram->max)
+    );
+  }
+}
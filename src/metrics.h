@@ -0,0 +1,44 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "histogram.h"
+
+
+enum MetricId {
+  METRIC_ID_FRAME_TIME,
+  METRIC_ID_INPUT_LATENCY,
+  METRIC_ID_CELLS_REVEALED,
+  METRIC_ID_FRAME_BYTES,
+  METRIC_ID_LOG_BACKLOG,
+  METRIC_ID_MAX
+};
+
+
+/**
+ * Counters shown by the performance overlay. Every value is also kept in a
+ * histogram for the summary printed when the game quits.
+ */
+struct Metrics {
+  struct Histogram histograms[METRIC_ID_MAX];
+  long last[METRIC_ID_MAX];
+  // When the oldest input not rendered yet was read, 0 if none.
+  long input_time_ns;
+  bool enable;
+};
+
+
+void metrics_init(struct Metrics* metrics);
+long metrics_now_ns();
+void metrics_record(struct Metrics* metrics, enum MetricId id, long value);
+void metrics_input_received(struct Metrics* metrics);
+void metrics_frame_rendered(struct Metrics* metrics, long frame_time_ns, long frame_bytes);
+const char* metrics_get_label(enum MetricId id);
+long metrics_get_display_value(enum MetricId id, long value);
+void metrics_toggle(struct Metrics* metrics);
+void metrics_print_summary(struct Metrics* metrics, FILE* file);
+
+
+#endif
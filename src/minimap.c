@@ -0,0 +1,105 @@
+#include "minimap.h"
+
+
+void minimap_init(struct Minimap* minimap, int width_max, int height_max) {
+  minimap->width = 0;
+  minimap->height = 0;
+  minimap->width_max = imin(width_max, MINIMAP_WIDTH_MAX);
+  minimap->height_max = imin(height_max, MINIMAP_HEIGHT_MAX);
+  minimap->block_width = 1;
+  minimap->block_height = 1;
+  minimap->enable = false;
+}
+
+
+enum MinimapCellState minimap_cell_state(struct GameBoard* game_board, int i) {
+  if (game_board->visibility_map[i]) return MINIMAP_CELL_STATE_REVEALED;
+  if (game_board->markers[i] == BOARD_CELL_TYPE_MINE_MARKER) {
+    return MINIMAP_CELL_STATE_FLAGGED;
+  }
+  return MINIMAP_CELL_STATE_HIDDEN;
+}
+
+
+int minimap_block_index(struct Minimap* minimap, struct GameBoard* game_board, int i) {
+  int x = game_board_get_column(game_board, i) / minimap->block_width;
+  int y = game_board_get_line(game_board, i) / minimap->block_height;
+  return y * minimap->width + x;
+}
+
+
+/**
+ * Rescan the whole board. Only needed when the board is created.
+ */
+void minimap_reset(struct Minimap* minimap, struct GameBoard* game_board) {
+  log_info("minimap_reset(minimap, game_board)");
+  int width = game_board->width;
+  int height = game_board->height;
+  minimap->block_width = (width + minimap->width_max - 1) / minimap->width_max;
+  minimap->block_height = (height + minimap->height_max - 1) / minimap->height_max;
+  minimap->width = (width + minimap->block_width - 1) / minimap->block_width;
+  minimap->height = (height + minimap->block_height - 1) / minimap->block_height;
+
+  for (int state = 0; state < MINIMAP_CELL_STATE_MAX; state++) {
+    for (int block = 0; block < minimap->width * minimap->height; block++) {
+      minimap->counts[state][block] = 0;
+    }
+  }
+
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      int i = game_board_get_index(game_board, x, y);
+      enum MinimapCellState state = minimap_cell_state(game_board, i);
+      minimap->cell_state[i] = state;
+      minimap->counts[state][minimap_block_index(minimap, game_board, i)]++;
+    }
+  }
+}
+
+
+/**
+ * Apply the cells of a delta, or rescan the board when it overflowed.
+ */
+void minimap_update(
+    struct Minimap* minimap,
+    struct GameBoard* game_board,
+    struct GameBoardDelta* delta
+) {
+  if (delta->overflow) {
+    minimap_reset(minimap, game_board);
+    return;
+  }
+
+  for (int change_i = 0; change_i < delta->count; change_i++) {
+    int i = delta->cells[change_i];
+    enum MinimapCellState state = minimap_cell_state(game_board, i);
+    if (state == minimap->cell_state[i]) continue;
+    int block = minimap_block_index(minimap, game_board, i);
+    minimap->counts[(int)minimap->cell_state[i]][block]--;
+    minimap->counts[state][block]++;
+    minimap->cell_state[i] = state;
+  }
+}
+
+
+/**
+ * Pick a glyph from the density of hidden and flagged cells of a block.
+ */
+int minimap_get_glyph(struct Minimap* minimap, int x, int y) {
+  int block = y * minimap->width + x;
+  int revealed = minimap->counts[MINIMAP_CELL_STATE_REVEALED][block];
+  int flagged = minimap->counts[MINIMAP_CELL_STATE_FLAGGED][block];
+  int hidden = minimap->counts[MINIMAP_CELL_STATE_HIDDEN][block];
+
+  if (flagged > 0 && flagged * 2 >= hidden) return BOARD_CELL_TYPE_MINE_MARKER;
+  if (hidden + flagged == 0) return ' ';
+  if (revealed == 0) return RENDER_GLYPH_CKBOARD;
+  if (hidden * 2 >= revealed) return RENDER_GLYPH_BOARD;
+  return RENDER_GLYPH_BULLET;
+}
+
+
+void minimap_toggle(struct Minimap* minimap) {
+  minimap->enable = !minimap->enable;
+  log_info_f("minimap->enable=%s", boolean_as_string(minimap->enable));
+}
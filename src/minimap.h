@@ -0,0 +1,52 @@
+#ifndef MINIMAP_H
+#define MINIMAP_H
+
+
+#include "game_board.h"
+#include "render_backend.h"
+
+
+#define MINIMAP_WIDTH_MAX 64
+#define MINIMAP_HEIGHT_MAX 64
+#define MINIMAP_SIZE_MAX (MINIMAP_WIDTH_MAX * MINIMAP_HEIGHT_MAX)
+
+
+enum MinimapCellState {
+  MINIMAP_CELL_STATE_HIDDEN,
+  MINIMAP_CELL_STATE_REVEALED,
+  MINIMAP_CELL_STATE_FLAGGED,
+  MINIMAP_CELL_STATE_MAX
+};
+
+
+/**
+ * Downsampled view of the game board.
+ * Each glyph summarises a block of `block_width` x `block_height` cells.
+ * Block counters are kept up to date from the game board deltas so
+ * the board is only rescanned when it is reset.
+ */
+struct Minimap {
+  int width;
+  int height;
+  int width_max;
+  int height_max;
+  int block_width;
+  int block_height;
+  char cell_state[GAME_BOARD_INDEX_MAX];
+  int counts[MINIMAP_CELL_STATE_MAX][MINIMAP_SIZE_MAX];
+  bool enable;
+};
+
+
+void minimap_init(struct Minimap* minimap, int width_max, int height_max);
+void minimap_reset(struct Minimap* minimap, struct GameBoard* game_board);
+void minimap_update(
+    struct Minimap* minimap,
+    struct GameBoard* game_board,
+    struct GameBoardDelta* delta
+);
+int minimap_get_glyph(struct Minimap* minimap, int x, int y);
+void minimap_toggle(struct Minimap* minimap);
+
+
+#endif
@@ -0,0 +1,51 @@
+#include "recorder.h"
+
+
+void recorder_init(struct Recorder* recorder) {
+  recorder->file = NULL;
+}
+
+
+/**
+ * Start recording when $MINESWEEPER_RECORD names the file to write.
+ */
+void recorder_open_user_file(struct Recorder* recorder) {
+  const char* path = getenv(RECORDER_FILE_ENV);
+  if (path == NULL) return;
+  recorder->file = fopen(path, "w");
+  if (recorder->file == NULL) {
+    log_fatal_f("fopen(\"%s\") failed (%d): %s\n", path, errno, strerror(errno));
+  }
+  log_info_f("Recording session to %s", path);
+}
+
+
+void recorder_new_game(struct Recorder* recorder, struct Game* game) {
+  if (recorder->file == NULL) return;
+  fprintf(
+      recorder->file,
+      "new %d %d %d %u\n",
+      game->game_board.width,
+      game->game_board.height,
+      game->density,
+      game->seed
+  );
+}
+
+
+void recorder_command(
+    struct Recorder* recorder,
+    enum CommandStreamCommand command,
+    int x,
+    int y
+) {
+  if (recorder->file == NULL) return;
+  fprintf(recorder->file, "%c %d %d\n", command, x, y);
+}
+
+
+void recorder_close(struct Recorder* recorder) {
+  if (recorder->file == NULL) return;
+  fclose(recorder->file);
+  recorder->file = NULL;
+}
@@ -0,0 +1,34 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+
+#include <stdio.h>
+#include "game.h"
+#include "command_stream.h"
+
+
+#define RECORDER_FILE_ENV "MINESWEEPER_RECORD"
+
+
+/**
+ * Writes the board operations of an interactive session as command stream
+ * text, so `minesweeper --pipe` can replay the session headless.
+ */
+struct Recorder {
+  FILE* file;
+};
+
+
+void recorder_init(struct Recorder* recorder);
+void recorder_open_user_file(struct Recorder* recorder);
+void recorder_new_game(struct Recorder* recorder, struct Game* game);
+void recorder_command(
+    struct Recorder* recorder,
+    enum CommandStreamCommand command,
+    int x,
+    int y
+);
+void recorder_close(struct Recorder* recorder);
+
+
+#endif
@@ -1,8 +1,14 @@
 #include "render.h"
 
 
-void render_help_menu() {
-  mvaddstr(0, 0, "Press `Esc` to display the menu.");
+void render_help_menu(struct RenderBackend* backend) {
+  render_backend_put_string(
+      backend,
+      RENDER_BACKEND_SCREEN,
+      0,
+      0,
+      "Press `Esc` to display the menu."
+  );
 }
 
 
@@ -12,252 +18,403 @@ void render_center_text(
     int y,
     const char* text
 ) {
-  WINDOW* window = window_manager_get_window(window_manager, window_id);
   int width = window_manager_get_width(window_manager, window_id);
   int left = width / 2 - strlen(text) / 2;
-  mvwaddstr(window, y, left, text);
+  window_manager_put_string(window_manager, window_id, y, left, text);
 }
 
 
-void render_game_board(struct GameBoard* game_board, int left, int top) {
-  int width = game_board->width;
-  int height = game_board->height;
+int render_game_board_cell(
+    struct GameBoard* game_board,
+    struct RevealAnimation* reveal_animation,
+    int i
+) {
   char* board = game_board->board;
-  bool* visibility_map = game_board->visibility_map;
   char* markers = game_board->markers;
 
-  int line = top;
-  move(line, left);
-  addch(ACS_ULCORNER);
-  for (int x = 0; x < width; x++) {
-    addch(ACS_HLINE);
+  if (game_board->visibility_map[i] && !reveal_animation_is_pending(reveal_animation, i)) {
+    if (board[i] == BOARD_CELL_TYPE_MINE) {
+      return BOARD_CELL_TYPE_MINE;
+    } else if (board[i] == BOARD_CELL_TYPE_EMPTY) {
+      return BOARD_CELL_TYPE_EMPTY;
+    } else {
+      return '0' + board[i];
+    }
+  } else if (markers[i] == BOARD_CELL_TYPE_OK_MARKER) {
+    return BOARD_CELL_TYPE_OK_MARKER;
+  } else if (markers[i] == BOARD_CELL_TYPE_MINE_MARKER) {
+    return BOARD_CELL_TYPE_MINE_MARKER;
+  } else {
+    return RENDER_GLYPH_CKBOARD;
   }
-  addch(ACS_URCORNER);
+}
+
+
+void render_game_board(
+    struct RenderBackend* backend,
+    struct GameBoard* game_board,
+    struct RevealAnimation* reveal_animation,
+    int left,
+    int top
+) {
+  int width = game_board->width;
+  int height = game_board->height;
+  int screen = RENDER_BACKEND_SCREEN;
 
-  line++;
+  render_backend_put_char(backend, screen, top, left, RENDER_GLYPH_ULCORNER);
+  render_backend_put_char(backend, screen, top + height + 1, left, RENDER_GLYPH_LLCORNER);
+  for (int x = 1; x <= width; x++) {
+    render_backend_put_char(backend, screen, top, left + x, RENDER_GLYPH_HLINE);
+    render_backend_put_char(backend, screen, top + height + 1, left + x, RENDER_GLYPH_HLINE);
+  }
+  render_backend_put_char(backend, screen, top, left + width + 1, RENDER_GLYPH_URCORNER);
+  render_backend_put_char(
+      backend,
+      screen,
+      top + height + 1,
+      left + width + 1,
+      RENDER_GLYPH_LRCORNER
+  );
 
   for (int y = 0; y < height; y++) {
-    move(line, left);
-    addch(ACS_VLINE);
+    int line = top + y + 1;
+    render_backend_put_char(backend, screen, line, left, RENDER_GLYPH_VLINE);
     for (int x = 0; x < width; x++) {
       int i = game_board_get_index(game_board, x, y);
-      if (visibility_map[i]) {
-        if (board[i] == BOARD_CELL_TYPE_MINE) {
-          addch(BOARD_CELL_TYPE_MINE);
-        } else if (board[i] == BOARD_CELL_TYPE_EMPTY) {
-          addch(BOARD_CELL_TYPE_EMPTY);
-        } else {
-          addch((char)'0' + board[i]);
-        }
-      } else if (markers[i] == BOARD_CELL_TYPE_OK_MARKER) {
-        addch(BOARD_CELL_TYPE_OK_MARKER);
-      } else if (markers[i] == BOARD_CELL_TYPE_MINE_MARKER) {
-        addch(BOARD_CELL_TYPE_MINE_MARKER);
-      } else {
-        addch(BOARD_CELL_TYPE_HIDDEN);
-      }
+      render_backend_put_char(
+          backend,
+          screen,
+          line,
+          left + x + 1,
+          render_game_board_cell(game_board, reveal_animation, i)
+      );
     }
-    addch(ACS_VLINE);
-    line++;
+    render_backend_put_char(backend, screen, line, left + width + 1, RENDER_GLYPH_VLINE);
   }
-
-  move(line, left);
-  addch(ACS_LLCORNER);
-  for (int x = 0; x < width; x++) {
-    addch(ACS_HLINE);
-  }
-  addch(ACS_LRCORNER);
 }
 
 
-void render_in_game(struct Game* game, struct Vector center) {
-  struct GameBoard* game_board = &game->game_board;
-  struct Cursor* cursor = &game->cursor;
-  int game_board_left = center.x - (game_board->width + 2) / 2;
-  int game_board_top = center.y - (game_board->height + 2) / 2;
+/**
+ * Top left corner of the game board border.
+ */
+struct Vector render_game_board_origin(struct GameBoard* game_board, struct Vector center) {
+  struct Vector origin;
+  origin.x = center.x - (game_board->width + 2) / 2;
+  origin.y = center.y - (game_board->height + 2) / 2;
+  return origin;
+}
 
-  render_game_board(game_board, game_board_left, game_board_top);
 
+void render_game_board_cursor(
+    struct RenderBackend* backend,
+    struct Game* game,
+    struct Vector origin,
+    enum CursorVisibility cursor_visibility
+) {
   const int border = 1;
-  move(
-      cursor->y + border + game_board_top,
-      cursor->x + border + game_board_left
+  render_backend_set_cursor(
+      backend,
+      game->cursor.y + border + origin.y,
+      game->cursor.x + border + origin.x,
+      cursor_visibility
   );
 }
 
 
+void render_in_game(
+    struct RenderBackend* backend,
+    struct Game* game,
+    struct RevealAnimation* reveal_animation,
+    struct Vector center,
+    enum CursorVisibility cursor_visibility
+) {
+  struct GameBoard* game_board = &game->game_board;
+  struct Vector origin = render_game_board_origin(game_board, center);
+  render_game_board(backend, game_board, reveal_animation, origin.x, origin.y);
+  render_game_board_cursor(backend, game, origin, cursor_visibility);
+}
+
+
+void render_minimap(struct Minimap* minimap, struct WindowManager* window_manager) {
+  if (!minimap->enable) return;
+  enum WindowId id = WINDOW_ID_MINIMAP;
+  window_manager_setup_window(window_manager, id);
+  for (int y = 0; y < minimap->height; y++) {
+    for (int x = 0; x < minimap->width; x++) {
+      window_manager_put_char(window_manager, id, y + 1, x + 1, minimap_get_glyph(minimap, x, y));
+    }
+  }
+}
+
+
 void render_game_menu(
     struct ItemSelection* game_menu,
     struct GameBoard* game_board,
-    struct WindowManager* window_manager,
-    int center_x,
-    int center_y
+    struct WindowManager* window_manager
 ) {
   enum WindowId id = WINDOW_ID_GAME_MENU;
-  WINDOW* window = window_manager_setup_window(
-      window_manager,
-      id,
-      center_x,
-      center_y
-  );
+  window_manager_setup_window(window_manager, id);
 
   char* title = "MENU";
   int text_x = (window_manager_get_width(window_manager, id) - strlen(title)) / 2;
   int text_y = 2;
-  mvwaddstr(window, text_y, text_x, title);
-  mvwaddstr(window, text_y + 1, text_x, "====");
+  window_manager_put_string(window_manager, id, text_y, text_x, title);
+  window_manager_put_string(window_manager, id, text_y + 1, text_x, "====");
 
   text_x = 12;
   text_y += 3;
   int space_y = 2;
   if (game_board_is_playing(game_board)) {
-    mvwaddstr(window, text_y + space_y * 0, text_x, "Resume");
+    window_manager_put_string(window_manager, id, text_y + space_y * 0, text_x, "Resume");
   }
-  mvwaddstr(window, text_y + space_y * 1, text_x, "New Game");
-  mvwaddstr(window, text_y + space_y * 2, text_x, "Manual");
-  mvwaddstr(window, text_y + space_y * 3, text_x, "Quit");
+  window_manager_put_string(window_manager, id, text_y + space_y * 1, text_x, "New Game");
+  window_manager_put_string(window_manager, id, text_y + space_y * 2, text_x, "Manual");
+  window_manager_put_string(window_manager, id, text_y + space_y * 3, text_x, "Stats");
+  window_manager_put_string(window_manager, id, text_y + space_y * 4, text_x, "Quit");
 
   // Render cursor.
-  mvwaddch(window, text_y + (item_selection_get_selection(game_menu) * space_y), 9, '>');
+  window_manager_put_char(
+      window_manager,
+      id,
+      text_y + (item_selection_get_selection(game_menu) * space_y),
+      9,
+      '>'
+  );
 }
 
 
-void render_menu(
-    struct Menu* menu,
-    struct WindowManager* window_manager,
-    struct Vector center
-) {
-  WINDOW* window = window_manager_setup_window(
-      window_manager,
-      WINDOW_ID_MENU,
-      center.x,
-      center.y
-  );
+void render_menu(struct Menu* menu, struct WindowManager* window_manager) {
+  enum WindowId id = WINDOW_ID_MENU;
+  window_manager_setup_window(window_manager, id);
 
 
-  int text_x = window_manager_get_width(window_manager, WINDOW_ID_MENU) / 2 - 11;
+  int text_x = window_manager_get_width(window_manager, id) / 2 - 11;
   int text_y = 3;
-  mvwaddstr(window, text_y, text_x, "CHOOSE YOUR DIFFICULTY");
-  mvwaddstr(window, text_y + 1, text_x, "======================");
+  window_manager_put_string(window_manager, id, text_y, text_x, "CHOOSE YOUR DIFFICULTY");
+  window_manager_put_string(window_manager, id, text_y + 1, text_x, "======================");
 
   int start_x = 10;
   int start_y = 6;
-  mvwaddstr(window, start_y + 0, start_x + 2, "Easy");
-  mvwaddstr(window, start_y + 2, start_x + 2, "Medium");
-  mvwaddstr(window, start_y + 4, start_x + 2, "Hard");
+  window_manager_put_string(window_manager, id, start_y + 0, start_x + 2, "Easy");
+  window_manager_put_string(window_manager, id, start_y + 2, start_x + 2, "Medium");
+  window_manager_put_string(window_manager, id, start_y + 4, start_x + 2, "Hard");
 
   // Render cursor.
-  mvwaddch(window, start_y + (menu->menu_selection * 2), start_x, '>');
+  window_manager_put_char(window_manager, id, start_y + (menu->menu_selection * 2), start_x, '>');
 }
 
 
-void render_game_won(
-    struct WindowManager* window_manager,
-    struct Vector center
-) {
-  WINDOW* window = window_manager_setup_window(
-      window_manager,
-      WINDOW_ID_GAME_WON,
-      center.x,
-      center.y
-  );
-  mvwaddstr(window, 1, 1, " YOU WON ");
+void render_game_won(struct WindowManager* window_manager) {
+  window_manager_setup_window(window_manager, WINDOW_ID_GAME_WON);
+  window_manager_put_string(window_manager, WINDOW_ID_GAME_WON, 1, 1, " YOU WON ");
 }
 
 
-void render_game_over(
-    struct WindowManager* window_manager,
-    struct Vector center
-) {
-  WINDOW* window = window_manager_setup_window(
-      window_manager,
-      WINDOW_ID_GAME_OVER,
-      center.x,
-      center.y
-  );
-  mvwaddstr(window, 1, 1, " GAME OVER ");
+void render_hud(struct Metrics* metrics, struct WindowManager* window_manager) {
+  if (!metrics->enable) return;
+  enum WindowId id = WINDOW_ID_HUD;
+  char line[32];
+  window_manager_setup_window(window_manager, id);
+  snprintf(line, sizeof(line), "%-8s%7s%9s", "", "last", "p99");
+  window_manager_put_string(window_manager, id, 1, 1, line);
+  for (int metric = 0; metric < METRIC_ID_MAX; metric++) {
+    snprintf(
+        line,
+        sizeof(line),
+        "%-8s%7ld%9ld",
+        metrics_get_label(metric),
+        metrics_get_display_value(metric, metrics->last[metric]),
+        metrics_get_display_value(
+            metric,
+            histogram_get_percentile(&metrics->histograms[metric], 99)
+        )
+    );
+    window_manager_put_string(window_manager, id, metric + 2, 1, line);
+  }
 }
 
 
-void render_manual(
-    struct Manual* manual,
-    struct WindowManager* window_manager,
-    struct Vector center
-) {
-  WINDOW* window = window_manager_setup_window(
-      window_manager,
-      WINDOW_ID_MANUAL,
-      center.x,
-      center.y
-  );
+void render_game_over(struct WindowManager* window_manager) {
+  window_manager_setup_window(window_manager, WINDOW_ID_GAME_OVER);
+  window_manager_put_string(window_manager, WINDOW_ID_GAME_OVER, 1, 1, " GAME OVER ");
+}
+
 
-  int height = window_manager_get_height(window_manager, WINDOW_ID_MANUAL) - 2;
+void render_manual(struct Manual* manual, struct WindowManager* window_manager) {
+  enum WindowId id = WINDOW_ID_MANUAL;
+  window_manager_setup_window(window_manager, id);
+
+  int height = window_manager_get_height(window_manager, id) - 2;
   if (height <= 0) return;
   const char* page[height];
   manual_get_page(manual, page, height);
   for (int i = 0; i < height; i++) {
-    mvwaddstr(window, i+1, 1, page[i]);
+    window_manager_put_string(window_manager, id, i+1, 1, page[i]);
   }
 }
 
 
-void render(struct Vector center, struct UI* ui, struct Game* game) {
+void render_stats_time(char* text, size_t size, uint32_t time_ms) {
+  snprintf(text, size, "%u.%us", time_ms / 1000, time_ms % 1000 / 100);
+}
+
+
+/**
+ * One difficulty at a time, switched with left and right.
+ */
+void render_stats(struct Stats* stats, struct WindowManager* window_manager) {
+  enum WindowId id = WINDOW_ID_STATS;
+  window_manager_setup_window(window_manager, id);
+  char line[64];
+  snprintf(line, sizeof(line), "< %s >", stats_get_difficulty_name(stats->difficulty));
+  window_manager_put_string(
+      window_manager,
+      id,
+      1,
+      (window_manager_get_width(window_manager, id) - strlen(line)) / 2,
+      line
+  );
+
+  const struct StatsSummary* summary = stats_get_summary(stats, stats->difficulty);
+  if (summary == NULL) {
+    window_manager_put_string(window_manager, id, 3, 2, "No statistics file.");
+    return;
+  }
+  long win_rate = summary->played_count > 0
+    ? (long)(summary->won_count * 100 / summary->played_count)
+    : 0;
+  snprintf(line, sizeof(line), "Played %9lu", summary->played_count);
+  window_manager_put_string(window_manager, id, 3, 2, line);
+  snprintf(line, sizeof(line), "Won    %9lu %4ld%%", summary->won_count, win_rate);
+  window_manager_put_string(window_manager, id, 4, 2, line);
+  snprintf(line, sizeof(line), "Streak %9u best %u", summary->streak, summary->best_streak);
+  window_manager_put_string(window_manager, id, 5, 2, line);
+
+  window_manager_put_string(window_manager, id, 7, 2, "Best times   3BV clicks");
+  for (int i = 0; i < summary->leaderboard_size; i++) {
+    const struct StatsLeaderboardEntry* entry = &summary->leaderboard[i];
+    char time[16];
+    render_stats_time(time, sizeof(time), entry->time_ms);
+    snprintf(line, sizeof(line), "%d. %8s %5u %6u", i + 1, time, entry->bbbv, entry->click_count);
+    window_manager_put_string(window_manager, id, 8 + i, 2, line);
+  }
+}
+
+
+void render_terminal_too_small(struct RenderBackend* backend) {
+  log_info("Terminal height is less than the minimum allowed.");
+  render_backend_begin_frame(backend);
+  render_backend_put_string(
+      backend,
+      RENDER_BACKEND_SCREEN,
+      0,
+      0,
+      "Terminal height is less than the minimum allowed."
+  );
+  render_backend_put_string(backend, RENDER_BACKEND_SCREEN, 1, 0, "Please resize the terminal.");
+  render_backend_set_cursor(backend, 2, 0, CURSOR_VISIBILITY_NORMAL);
+  render_backend_end_frame(backend);
+}
+
+
+void render(struct UI* ui, struct Game* game) {
   enum GameState game_state = game->game_state;
   struct WindowManager* window_manager = &ui->window_manager;
+  struct RenderBackend* backend = ui->render_backend;
+  struct Vector center = ui->terminal.center;
+
+  if (ui->terminal.is_too_small) {
+    render_terminal_too_small(backend);
+    return;
+  }
 
-  erase();
+  render_backend_begin_frame(backend);
   window_manager_erase(window_manager);
-  render_help_menu();
+  render_help_menu(backend);
+  minimap_update(&ui->minimap, &game->game_board, &game->delta);
+  game_board_delta_clear(&game->delta);
 
   switch (game_state) {
     case GAME_STATE_START_MENU:
       log_info("Game menu is enabled.");
-      render_game_menu(
-          &ui->game_menu,
-          &game->game_board,
-          window_manager,
-          center.x,
-          center.y
-      );
+      render_game_menu(&ui->game_menu, &game->game_board, window_manager);
 
-      curs_set(CURSOR_VISIBILITY_INVISIBLE);
-      move(0, 0);
+      render_backend_set_cursor(backend, 0, 0, CURSOR_VISIBILITY_INVISIBLE);
       break;
     case GAME_STATE_IN_GAME:
-      render_in_game(game, center);
-      curs_set(CURSOR_VISIBILITY_HIGH_VISIBILITY);
+      render_minimap(&ui->minimap, window_manager);
+      render_in_game(backend, game, &ui->reveal_animation, center, CURSOR_VISIBILITY_HIGH_VISIBILITY);
       break;
     case GAME_STATE_GAME_OVER:
-      render_in_game(game, center);
-      render_game_over(window_manager, center);
+      render_in_game(backend, game, &ui->reveal_animation, center, CURSOR_VISIBILITY_INVISIBLE);
+      render_minimap(&ui->minimap, window_manager);
+      render_game_over(window_manager);
 
-      curs_set(CURSOR_VISIBILITY_INVISIBLE);
-      move(0, 0);
+      render_backend_set_cursor(backend, 0, 0, CURSOR_VISIBILITY_INVISIBLE);
       break;
     case GAME_STATE_GAME_WON:
-      render_in_game(game, center);
-      render_game_won(window_manager, center);
+      render_in_game(backend, game, &ui->reveal_animation, center, CURSOR_VISIBILITY_INVISIBLE);
+      render_minimap(&ui->minimap, window_manager);
+      render_game_won(window_manager);
 
-      curs_set(CURSOR_VISIBILITY_INVISIBLE);
-      move(0, 0);
+      render_backend_set_cursor(backend, 0, 0, CURSOR_VISIBILITY_INVISIBLE);
       break;
     case GAME_STATE_MENU:
-      render_menu(&ui->menu, window_manager, center);
+      render_menu(&ui->menu, window_manager);
 
-      curs_set(CURSOR_VISIBILITY_INVISIBLE);
-      move(0, 0);
+      render_backend_set_cursor(backend, 0, 0, CURSOR_VISIBILITY_INVISIBLE);
       break;
     case GAME_STATE_MANUAL:
-      render_manual(&ui->manual, window_manager, center);
+      render_manual(&ui->manual, window_manager);
+
+      render_backend_set_cursor(backend, 0, 0, CURSOR_VISIBILITY_INVISIBLE);
+      break;
+    case GAME_STATE_STATS:
+      render_stats(&ui->stats, window_manager);
 
-      curs_set(CURSOR_VISIBILITY_INVISIBLE);
-      move(0, 0);
+      render_backend_set_cursor(backend, 0, 0, CURSOR_VISIBILITY_INVISIBLE);
       break;
     default: 
       log_fatal_f("Invalid game_state: %d", game_state);
   }
 
-  refresh();
-  window_manager_render(window_manager);
+  render_hud(&ui->metrics, window_manager);
+  render_backend_end_frame(backend);
 }
 
+
+/**
+ * Draw the next frame of the reveal animation. Only the cells shown by this
+ * frame are drawn, over the last frame. Overlays are only drawn while
+ * playing, so the animation is cut short in any other state.
+ */
+void render_reveal_animation(struct UI* ui, struct Game* game) {
+  struct RevealAnimation* reveal_animation = &ui->reveal_animation;
+  struct RenderBackend* backend = ui->render_backend;
+  struct GameBoard* game_board = &game->game_board;
+
+  if (game->game_state != GAME_STATE_IN_GAME || ui->terminal.is_too_small) {
+    reveal_animation_stop(reveal_animation);
+    render(ui, game);
+    return;
+  }
+
+  int first = reveal_animation->shown;
+  reveal_animation_update(reveal_animation);
+  if (first == reveal_animation->shown) return;
+
+  struct Vector origin = render_game_board_origin(game_board, ui->terminal.center);
+  render_backend_begin_partial_frame(backend);
+  for (int cell_i = first; cell_i < reveal_animation->shown; cell_i++) {
+    int i = reveal_animation->cells[cell_i];
+    render_backend_put_char(
+        backend,
+        RENDER_BACKEND_SCREEN,
+        origin.y + 1 + game_board_get_line(game_board, i),
+        origin.x + 1 + game_board_get_column(game_board, i),
+        render_game_board_cell(game_board, reveal_animation, i)
+    );
+  }
+  render_game_board_cursor(backend, game, origin, CURSOR_VISIBILITY_HIGH_VISIBILITY);
+  render_backend_end_frame(backend);
+}
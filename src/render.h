@@ -9,7 +9,8 @@
 #include "ui.h"
 
 
-void render(struct Vector center, struct UI* ui, struct Game* game);
+void render(struct UI* ui, struct Game* game);
+void render_reveal_animation(struct UI* ui, struct Game* game);
 
 
 #endif
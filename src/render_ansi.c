@@ -0,0 +1,442 @@
+#include "render_ansi.h"
+
+
+#define RENDER_ANSI_KEY_ESC 27
+
+
+
+
+/**
+ * DEC special graphics characters, used after `ESC ( 0`.
+ */
+const char g_render_ansi_line_drawing[] = {
+  'l',  // RENDER_GLYPH_ULCORNER
+  'k',  // RENDER_GLYPH_URCORNER
+  'm',  // RENDER_GLYPH_LLCORNER
+  'j',  // RENDER_GLYPH_LRCORNER
+  'q',  // RENDER_GLYPH_HLINE
+  'x',  // RENDER_GLYPH_VLINE
+  'a',  // RENDER_GLYPH_CKBOARD
+  'h',  // RENDER_GLYPH_BOARD
+  '~',  // RENDER_GLYPH_BULLET
+};
+
+
+const char g_render_ansi_leave[] = "\x1b(B\x1b[?25h\x1b[?1049l";
+
+
+void render_ansi_restore_terminal(struct RenderAnsi* ansi) {
+  write(STDOUT_FILENO, g_render_ansi_leave, sizeof(g_render_ansi_leave) - 1);
+  tcsetattr(STDIN_FILENO, TCSAFLUSH, &ansi->termios);
+}
+
+
+/********************************************************************************
+* Output
+********************************************************************************/
+
+
+void render_ansi_flush(struct RenderBackend* backend, const char* suffix, int suffix_size) {
+  struct RenderAnsi* ansi = backend->data;
+  struct iovec iov[2];
+  iov[0].iov_base = ansi->output;
+  iov[0].iov_len = ansi->output_size;
+  iov[1].iov_base = (char*)suffix;
+  iov[1].iov_len = suffix_size;
+  int iov_i = 0;
+  while (iov_i < array_size(iov)) {
+    ssize_t n = writev(STDOUT_FILENO, iov + iov_i, array_size(iov) - iov_i);
+    if (n == -1) {
+      if (errno == EINTR) continue;
+      log_error_f("writev() failed (%d): %s", errno, strerror(errno));
+      break;
+    }
+    render_backend_add_bytes(backend, n);
+    // Skip what was written, usually everything.
+    while (iov_i < array_size(iov) && n >= iov[iov_i].iov_len) {
+      n -= iov[iov_i].iov_len;
+      iov_i++;
+    }
+    if (iov_i < array_size(iov)) {
+      iov[iov_i].iov_base = (char*)iov[iov_i].iov_base + n;
+      iov[iov_i].iov_len -= n;
+    }
+  }
+  ansi->output_size = 0;
+}
+
+
+void render_ansi_append(struct RenderBackend* backend, const char* text, int size) {
+  struct RenderAnsi* ansi = backend->data;
+  if (ansi->output_size + size > RENDER_ANSI_OUTPUT_SIZE) {
+    render_ansi_flush(backend, "", 0);
+  }
+  memcpy(ansi->output + ansi->output_size, text, size);
+  ansi->output_size += size;
+}
+
+
+void render_ansi_append_glyph(struct RenderBackend* backend, int c) {
+  struct RenderAnsi* ansi = backend->data;
+  bool line_drawing = c >= RENDER_GLYPH_ULCORNER && c < RENDER_GLYPH_MAX;
+  if (line_drawing != ansi->output_line_drawing) {
+    render_ansi_append(backend, line_drawing ? "\x1b(0" : "\x1b(B", 3);
+    ansi->output_line_drawing = line_drawing;
+  }
+  char byte = line_drawing
+    ? g_render_ansi_line_drawing[c - RENDER_GLYPH_ULCORNER]
+    : render_backend_glyph_as_ascii(c);
+  render_ansi_append(backend, &byte, 1);
+
+  // After the last column the terminal cursor position is not reliable.
+  ansi->output_x++;
+  if (ansi->output_x >= ansi->width) ansi->output_x = -1;
+}
+
+
+/**
+ * Move the terminal cursor with the shortest sequence. Small gaps on the
+ * same line are cheaper to rewrite with the unchanged cells.
+ */
+void render_ansi_move(struct RenderBackend* backend, int y, int x) {
+  struct RenderAnsi* ansi = backend->data;
+  if (ansi->output_y == y && ansi->output_x == x) return;
+
+  char sequence[32];
+  int size;
+  int gap = x - ansi->output_x;
+  if (ansi->output_y == y && ansi->output_x >= 0 && gap > 0 && gap <= 3) {
+    int* back = ansi->back[y];
+    while (ansi->output_x < x) {
+      render_ansi_append_glyph(backend, back[ansi->output_x]);
+    }
+    return;
+  } else if (ansi->output_y == y && ansi->output_x >= 0 && gap > 0) {
+    size = snprintf(sequence, sizeof(sequence), "\x1b[%dC", gap);
+  } else {
+    size = snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", y + 1, x + 1);
+  }
+  render_ansi_append(backend, sequence, size);
+  ansi->output_y = y;
+  ansi->output_x = x;
+}
+
+
+/********************************************************************************
+* Backend
+********************************************************************************/
+
+
+void render_ansi_get_size(struct RenderBackend* backend, int* width, int* height) {
+  struct RenderAnsi* ansi = backend->data;
+  struct winsize ws;
+  int new_width = 80;
+  int new_height = 24;
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0) {
+    new_width = imin(ws.ws_col, RENDER_ANSI_WIDTH_MAX);
+    new_height = imin(ws.ws_row, RENDER_ANSI_HEIGHT_MAX);
+  }
+  if (new_width != ansi->width || new_height != ansi->height) {
+    ansi->width = new_width;
+    ansi->height = new_height;
+    ansi->needs_clear = true;
+  }
+  *width = ansi->width;
+  *height = ansi->height;
+}
+
+
+void render_ansi_resize(struct RenderBackend* backend) {
+}
+
+
+void render_ansi_set(
+    struct RenderBackend* backend,
+    int window_id,
+    int y,
+    int x,
+    int c
+) {
+  struct RenderAnsi* ansi = backend->data;
+  if (window_id != RENDER_BACKEND_SCREEN) {
+    if (x < 0 || x >= ansi->window_width[window_id]) return;
+    if (y < 0 || y >= ansi->window_height[window_id]) return;
+    x += ansi->left[window_id];
+    y += ansi->top[window_id];
+  }
+  if (x < 0 || x >= ansi->width || y < 0 || y >= ansi->height) return;
+  ansi->back[y][x] = c;
+}
+
+
+void render_ansi_begin_frame(struct RenderBackend* backend) {
+  struct RenderAnsi* ansi = backend->data;
+  for (int y = 0; y < ansi->height; y++) {
+    for (int x = 0; x < ansi->width; x++) {
+      ansi->back[y][x] = ' ';
+    }
+  }
+}
+
+
+void render_ansi_open_window(
+    struct RenderBackend* backend,
+    int window_id,
+    int left,
+    int top,
+    int width,
+    int height
+) {
+  struct RenderAnsi* ansi = backend->data;
+  ansi->left[window_id] = left;
+  ansi->top[window_id] = top;
+  ansi->window_width[window_id] = width;
+  ansi->window_height[window_id] = height;
+
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      int c = ' ';
+      if (y == 0 || y == height - 1) c = RENDER_GLYPH_HLINE;
+      if (x == 0 || x == width - 1) c = RENDER_GLYPH_VLINE;
+      if (y == 0 && x == 0) c = RENDER_GLYPH_ULCORNER;
+      if (y == 0 && x == width - 1) c = RENDER_GLYPH_URCORNER;
+      if (y == height - 1 && x == 0) c = RENDER_GLYPH_LLCORNER;
+      if (y == height - 1 && x == width - 1) c = RENDER_GLYPH_LRCORNER;
+      render_ansi_set(backend, window_id, y, x, c);
+    }
+  }
+}
+
+
+void render_ansi_put_string(
+    struct RenderBackend* backend,
+    int window_id,
+    int y,
+    int x,
+    const char* text
+) {
+  for (int i = 0; text[i] != '\0'; i++) {
+    render_ansi_set(backend, window_id, y, x + i, text[i]);
+  }
+}
+
+
+void render_ansi_set_cursor(
+    struct RenderBackend* backend,
+    int y,
+    int x,
+    enum CursorVisibility visibility
+) {
+  struct RenderAnsi* ansi = backend->data;
+  ansi->cursor_y = y;
+  ansi->cursor_x = x;
+  ansi->cursor_visibility = visibility;
+}
+
+
+/**
+ * Write the cells that differ from the previous frame.
+ */
+void render_ansi_end_frame(struct RenderBackend* backend) {
+  struct RenderAnsi* ansi = backend->data;
+  int (*front)[RENDER_ANSI_WIDTH_MAX] = ansi->front;
+  int (*back)[RENDER_ANSI_WIDTH_MAX] = ansi->back;
+
+  if (ansi->needs_clear) {
+    render_ansi_append(backend, "\x1b[H\x1b[2J", 7);
+    for (int y = 0; y < ansi->height; y++) {
+      for (int x = 0; x < ansi->width; x++) {
+        front[y][x] = ' ';
+      }
+    }
+    ansi->output_y = 0;
+    ansi->output_x = 0;
+    ansi->needs_clear = false;
+  }
+
+  for (int y = 0; y < ansi->height; y++) {
+    for (int x = 0; x < ansi->width; x++) {
+      if (back[y][x] == front[y][x]) continue;
+      render_ansi_move(backend, y, x);
+      render_ansi_append_glyph(backend, back[y][x]);
+      front[y][x] = back[y][x];
+    }
+  }
+
+  char suffix[32];
+  int suffix_size = 0;
+  int cursor_y = imax(0, ansi->cursor_y);
+  int cursor_x = imax(0, ansi->cursor_x);
+  if (ansi->output_y != cursor_y || ansi->output_x != cursor_x) {
+    suffix_size = snprintf(suffix, sizeof(suffix), "\x1b[%d;%dH", cursor_y + 1, cursor_x + 1);
+    ansi->output_y = cursor_y;
+    ansi->output_x = cursor_x;
+  }
+  const char* visibility = ansi->cursor_visibility == CURSOR_VISIBILITY_INVISIBLE
+    ? "\x1b[?25l"
+    : "\x1b[?25h";
+  memcpy(suffix + suffix_size, visibility, 6);
+  suffix_size += 6;
+
+  render_ansi_flush(backend, suffix, suffix_size);
+}
+
+
+void render_ansi_close(struct RenderBackend* backend) {
+  render_ansi_restore_terminal(backend->data);
+}
+
+
+/********************************************************************************
+* Keyboard
+********************************************************************************/
+
+
+/**
+ * Read what is available on stdin. Return false on timeout.
+ */
+bool render_ansi_fill_input(struct RenderAnsi* ansi, int timeout_ms) {
+  if (ansi->input_size >= RENDER_ANSI_INPUT_SIZE) return false;
+  struct pollfd pollfd = {STDIN_FILENO, POLLIN, 0};
+  if (poll(&pollfd, 1, timeout_ms) <= 0) return false;
+  ssize_t n = read(
+      STDIN_FILENO,
+      ansi->input + ansi->input_size,
+      RENDER_ANSI_INPUT_SIZE - ansi->input_size
+  );
+  if (n <= 0) return false;
+  ansi->input_size += n;
+  return true;
+}
+
+
+int render_ansi_pop_input(struct RenderAnsi* ansi, int size, int key) {
+  memmove(ansi->input, ansi->input + size, ansi->input_size - size);
+  ansi->input_size -= size;
+  return key;
+}
+
+
+/**
+ * Translate CSI and SS3 sequences to the ncurses key codes.
+ */
+int render_ansi_decode_sequence(unsigned char* sequence, int size) {
+  unsigned char final = sequence[size - 1];
+  if (size == 3) {
+    switch (final) {
+      case 'A': return KEY_UP;
+      case 'B': return KEY_DOWN;
+      case 'C': return KEY_RIGHT;
+      case 'D': return KEY_LEFT;
+      case 'H': return KEY_HOME;
+      case 'F': return KEY_END;
+    }
+  }
+  if (final == '~') {
+    switch (atoi((char*)sequence + 2)) {
+      case 1: return KEY_HOME;
+      case 2: return KEY_IC;
+      case 3: return KEY_DC;
+      case 4: return KEY_END;
+      case 5: return KEY_PPAGE;
+      case 6: return KEY_NPAGE;
+      case 7: return KEY_HOME;
+      case 8: return KEY_END;
+    }
+  }
+  return RENDER_BACKEND_NO_KEY;
+}
+
+
+int render_ansi_decode_key(struct RenderAnsi* ansi) {
+  unsigned char* input = ansi->input;
+  if (input[0] != RENDER_ANSI_KEY_ESC) {
+    return render_ansi_pop_input(ansi, 1, input[0] == 127 ? KEY_BACKSPACE : input[0]);
+  }
+
+  if (ansi->input_size == 1) render_ansi_fill_input(ansi, RENDER_ANSI_ESC_DELAY_MS);
+  if (ansi->input_size == 1 || (input[1] != '[' && input[1] != 'O')) {
+    return render_ansi_pop_input(ansi, 1, RENDER_ANSI_KEY_ESC);
+  }
+
+  // Parameters end with a byte in the 0x40-0x7e range.
+  int end = 2;
+  while (true) {
+    if (end >= ansi->input_size && !render_ansi_fill_input(ansi, RENDER_ANSI_ESC_DELAY_MS)) {
+      return render_ansi_pop_input(ansi, ansi->input_size, RENDER_BACKEND_NO_KEY);
+    }
+    if (input[end] >= 0x40 && input[end] <= 0x7e) break;
+    end++;
+  }
+  char sequence[RENDER_ANSI_INPUT_SIZE + 1];
+  memcpy(sequence, input, end + 1);
+  sequence[end + 1] = '\0';
+  int key = render_ansi_decode_sequence((unsigned char*)sequence, end + 1);
+  return render_ansi_pop_input(ansi, end + 1, key);
+}
+
+
+int render_ansi_read_key(struct RenderBackend* backend, int timeout_ms) {
+  struct RenderAnsi* ansi = backend->data;
+  while (true) {
+    if (ansi->input_size == 0 && !render_ansi_fill_input(ansi, timeout_ms)) {
+      if (timeout_ms < 0) continue;
+      return RENDER_BACKEND_NO_KEY;
+    }
+    int key = render_ansi_decode_key(ansi);
+    if (key != RENDER_BACKEND_NO_KEY) return key;
+  }
+}
+
+
+/********************************************************************************
+* Initialization
+********************************************************************************/
+
+
+void render_ansi_init(struct RenderBackend* backend, struct RenderAnsi* ansi) {
+  render_backend_init(backend, "ansi", ansi);
+  backend->get_size = render_ansi_get_size;
+  backend->resize = render_ansi_resize;
+  backend->begin_frame = render_ansi_begin_frame;
+  backend->open_window = render_ansi_open_window;
+  backend->put_char = render_ansi_set;
+  backend->put_string = render_ansi_put_string;
+  backend->set_cursor = render_ansi_set_cursor;
+  backend->end_frame = render_ansi_end_frame;
+  backend->read_key = render_ansi_read_key;
+  backend->close = render_ansi_close;
+
+  ansi->width = 0;
+  ansi->height = 0;
+  ansi->needs_clear = true;
+  ansi->cursor_y = 0;
+  ansi->cursor_x = 0;
+  ansi->cursor_visibility = CURSOR_VISIBILITY_NORMAL;
+  ansi->output_size = 0;
+  ansi->output_y = -1;
+  ansi->output_x = -1;
+  ansi->output_line_drawing = false;
+  ansi->input_size = 0;
+  for (int i = 0; i < WINDOW_ID_MAX; i++) {
+    ansi->left[i] = 0;
+    ansi->top[i] = 0;
+    ansi->window_width[i] = 0;
+    ansi->window_height[i] = 0;
+  }
+
+  // Keys are read one by one without echo, like ncurses `cbreak` mode.
+  if (tcgetattr(STDIN_FILENO, &ansi->termios) == -1) {
+    log_fatal_f("tcgetattr() failed (%d): %s\n", errno, strerror(errno));
+  }
+  struct termios raw = ansi->termios;
+  raw.c_lflag &= ~(ICANON | ECHO);
+  raw.c_iflag &= ~IXON;
+  raw.c_cc[VMIN] = 1;
+  raw.c_cc[VTIME] = 0;
+  tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+
+  const char enter[] = "\x1b[?1049h";
+  write(STDOUT_FILENO, enter, sizeof(enter) - 1);
+  render_backend_add_bytes(backend, sizeof(enter) - 1);
+}
@@ -0,0 +1,60 @@
+#ifndef RENDER_ANSI_H
+#define RENDER_ANSI_H
+
+
+#include <curses.h>
+#include <termios.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include "render_backend.h"
+#include "window_manager.h"
+#include "util.h"
+
+
+#define RENDER_ANSI_WIDTH_MAX 256
+#define RENDER_ANSI_HEIGHT_MAX 128
+#define RENDER_ANSI_OUTPUT_SIZE (RENDER_ANSI_WIDTH_MAX * RENDER_ANSI_HEIGHT_MAX * 4)
+#define RENDER_ANSI_INPUT_SIZE 64
+// Time to wait for the rest of an escape sequence after `ESC`.
+#define RENDER_ANSI_ESC_DELAY_MS 25
+
+
+/**
+ * Render backend writing ANSI sequences to stdout without ncurses.
+ * Frames are drawn into a back buffer, compared with the front buffer
+ * (what the terminal shows) and only the differences are written, with a
+ * single `writev` per frame. The back buffer keeps the last frame so
+ * partial frames can be drawn over it.
+ */
+struct RenderAnsi {
+  int width;
+  int height;
+  int front[RENDER_ANSI_HEIGHT_MAX][RENDER_ANSI_WIDTH_MAX];
+  int back[RENDER_ANSI_HEIGHT_MAX][RENDER_ANSI_WIDTH_MAX];
+  bool needs_clear;
+  int left[WINDOW_ID_MAX];
+  int top[WINDOW_ID_MAX];
+  int window_width[WINDOW_ID_MAX];
+  int window_height[WINDOW_ID_MAX];
+  int cursor_y;
+  int cursor_x;
+  enum CursorVisibility cursor_visibility;
+  // Output of the current frame and terminal state while writing it.
+  char output[RENDER_ANSI_OUTPUT_SIZE];
+  int output_size;
+  int output_y;
+  int output_x;
+  bool output_line_drawing;
+  // Bytes read from stdin and not decoded yet.
+  unsigned char input[RENDER_ANSI_INPUT_SIZE];
+  int input_size;
+  struct termios termios;
+};
+
+
+void render_ansi_init(struct RenderBackend* backend, struct RenderAnsi* ansi);
+
+
+#endif
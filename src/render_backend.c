@@ -0,0 +1,166 @@
+#include "render_backend.h"
+
+
+const char g_render_glyph_ascii[] = {
+  '+',  // RENDER_GLYPH_ULCORNER
+  '+',  // RENDER_GLYPH_URCORNER
+  '+',  // RENDER_GLYPH_LLCORNER
+  '+',  // RENDER_GLYPH_LRCORNER
+  '-',  // RENDER_GLYPH_HLINE
+  '|',  // RENDER_GLYPH_VLINE
+  '#',  // RENDER_GLYPH_CKBOARD
+  ':',  // RENDER_GLYPH_BOARD
+  '.',  // RENDER_GLYPH_BULLET
+};
+
+
+void render_backend_init(struct RenderBackend* backend, const char* name, void* data) {
+  log_info_f("render_backend_init(backend, \"%s\", data)", name);
+  backend->name = name;
+  backend->data = data;
+  backend->get_written_bytes = NULL;
+  backend->written_bytes_start = -1;
+  backend->frame_stats.frames = 0;
+  backend->frame_stats.cells = 0;
+  backend->frame_stats.bytes = 0;
+  backend->total_stats = backend->frame_stats;
+}
+
+
+void render_backend_get_size(struct RenderBackend* backend, int* width, int* height) {
+  backend->get_size(backend, width, height);
+}
+
+
+void render_backend_resize(struct RenderBackend* backend) {
+  backend->resize(backend);
+}
+
+
+void render_backend_begin_frame(struct RenderBackend* backend) {
+  backend->frame_stats.frames = 1;
+  backend->frame_stats.cells = 0;
+  backend->frame_stats.bytes = 0;
+  backend->begin_frame(backend);
+}
+
+
+/**
+ * Start a frame drawn over the previous one, only the cells that are put
+ * again are updated.
+ */
+void render_backend_begin_partial_frame(struct RenderBackend* backend) {
+  backend->frame_stats.frames = 1;
+  backend->frame_stats.cells = 0;
+  backend->frame_stats.bytes = 0;
+}
+
+
+void render_backend_open_window(
+    struct RenderBackend* backend,
+    int window_id,
+    int left,
+    int top,
+    int width,
+    int height
+) {
+  backend->frame_stats.cells += width * height;
+  backend->open_window(backend, window_id, left, top, width, height);
+}
+
+
+void render_backend_put_char(
+    struct RenderBackend* backend,
+    int window_id,
+    int y,
+    int x,
+    int c
+) {
+  backend->frame_stats.cells++;
+  backend->put_char(backend, window_id, y, x, c);
+}
+
+
+void render_backend_put_string(
+    struct RenderBackend* backend,
+    int window_id,
+    int y,
+    int x,
+    const char* text
+) {
+  backend->frame_stats.cells += strlen(text);
+  backend->put_string(backend, window_id, y, x, text);
+}
+
+
+void render_backend_set_cursor(
+    struct RenderBackend* backend,
+    int y,
+    int x,
+    enum CursorVisibility visibility
+) {
+  backend->set_cursor(backend, y, x, visibility);
+}
+
+
+void render_backend_end_frame(struct RenderBackend* backend) {
+  backend->end_frame(backend);
+  backend->total_stats.frames += backend->frame_stats.frames;
+  backend->total_stats.cells += backend->frame_stats.cells;
+  backend->total_stats.bytes += backend->frame_stats.bytes;
+}
+
+
+int render_backend_read_key(struct RenderBackend* backend, int timeout_ms) {
+  return backend->read_key(backend, timeout_ms);
+}
+
+
+void render_backend_close(struct RenderBackend* backend) {
+  log_info_f(
+      "render_backend_close: {name: %s, frames: %ld, cells: %ld, bytes: %ld}",
+      backend->name,
+      backend->total_stats.frames,
+      backend->total_stats.cells,
+      backend->total_stats.bytes
+  );
+  backend->close(backend);
+}
+
+
+/**
+ * Count the bytes written from here to `render_backend_end_byte_count`, for
+ * backends with `get_written_bytes`. Reading the count has a cost, so the
+ * caller keeps both calls out of the frame it times.
+ */
+void render_backend_begin_byte_count(struct RenderBackend* backend) {
+  if (backend->get_written_bytes == NULL) return;
+  backend->written_bytes_start = backend->get_written_bytes(backend);
+}
+
+
+void render_backend_end_byte_count(struct RenderBackend* backend) {
+  if (backend->get_written_bytes == NULL || backend->written_bytes_start < 0) return;
+  long written_bytes = backend->get_written_bytes(backend);
+  if (written_bytes >= backend->written_bytes_start) {
+    long bytes = written_bytes - backend->written_bytes_start;
+    backend->frame_stats.bytes += bytes;
+    backend->total_stats.bytes += bytes;
+  }
+  backend->written_bytes_start = -1;
+}
+
+
+/**
+ * Called by the backends for every byte sent to the output.
+ */
+void render_backend_add_bytes(struct RenderBackend* backend, long bytes) {
+  backend->frame_stats.bytes += bytes;
+}
+
+
+char render_backend_glyph_as_ascii(int c) {
+  if (c < RENDER_GLYPH_ULCORNER) return (char)c;
+  if (c >= RENDER_GLYPH_MAX) return '?';
+  return g_render_glyph_ascii[c - RENDER_GLYPH_ULCORNER];
+}
@@ -0,0 +1,131 @@
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+
+#include <stdbool.h>
+#include <string.h>
+#include "cursor.h"
+
+
+// Target of a draw call that is not one of the `WindowId` overlays.
+#define RENDER_BACKEND_SCREEN -1
+// Returned by `read_key` when there is no key to read.
+#define RENDER_BACKEND_NO_KEY -1
+
+
+/**
+ * Backend independent glyphs. Plain characters are passed as is, these
+ * values are above the char range and translated by each backend.
+ */
+enum RenderGlyph {
+  RENDER_GLYPH_ULCORNER = 256,
+  RENDER_GLYPH_URCORNER,
+  RENDER_GLYPH_LLCORNER,
+  RENDER_GLYPH_LRCORNER,
+  RENDER_GLYPH_HLINE,
+  RENDER_GLYPH_VLINE,
+  RENDER_GLYPH_CKBOARD,
+  RENDER_GLYPH_BOARD,
+  RENDER_GLYPH_BULLET,
+  RENDER_GLYPH_MAX
+};
+
+
+struct RenderStats {
+  long frames;
+  long cells;
+  long bytes;
+};
+
+
+/**
+ * Output used by `render`. Coordinates of overlay windows are relative to
+ * the window, coordinates of `RENDER_BACKEND_SCREEN` to the terminal.
+ */
+struct RenderBackend {
+  const char* name;
+  void* data;
+  void (*get_size)(struct RenderBackend* backend, int* width, int* height);
+  // Called when the terminal was resized, before `get_size`.
+  void (*resize)(struct RenderBackend* backend);
+  void (*begin_frame)(struct RenderBackend* backend);
+  void (*open_window)(
+      struct RenderBackend* backend,
+      int window_id,
+      int left,
+      int top,
+      int width,
+      int height
+  );
+  void (*put_char)(struct RenderBackend* backend, int window_id, int y, int x, int c);
+  void (*put_string)(
+      struct RenderBackend* backend,
+      int window_id,
+      int y,
+      int x,
+      const char* text
+  );
+  void (*set_cursor)(
+      struct RenderBackend* backend,
+      int y,
+      int x,
+      enum CursorVisibility visibility
+  );
+  void (*end_frame)(struct RenderBackend* backend);
+  // Terminal backends also own the keyboard. Keys use the ncurses codes.
+  // Wait at most `timeout_ms` for a key, forever when negative.
+  int (*read_key)(struct RenderBackend* backend, int timeout_ms);
+  void (*close)(struct RenderBackend* backend);
+  // Optional, for backends that can not count their output on the way:
+  // bytes written so far, or -1 when unknown.
+  long (*get_written_bytes)(struct RenderBackend* backend);
+  long written_bytes_start;
+  // Cells and bytes produced by the last frame and since the start.
+  struct RenderStats frame_stats;
+  struct RenderStats total_stats;
+};
+
+
+void render_backend_init(struct RenderBackend* backend, const char* name, void* data);
+void render_backend_get_size(struct RenderBackend* backend, int* width, int* height);
+void render_backend_resize(struct RenderBackend* backend);
+void render_backend_begin_frame(struct RenderBackend* backend);
+void render_backend_begin_partial_frame(struct RenderBackend* backend);
+void render_backend_open_window(
+    struct RenderBackend* backend,
+    int window_id,
+    int left,
+    int top,
+    int width,
+    int height
+);
+void render_backend_put_char(
+    struct RenderBackend* backend,
+    int window_id,
+    int y,
+    int x,
+    int c
+);
+void render_backend_put_string(
+    struct RenderBackend* backend,
+    int window_id,
+    int y,
+    int x,
+    const char* text
+);
+void render_backend_set_cursor(
+    struct RenderBackend* backend,
+    int y,
+    int x,
+    enum CursorVisibility visibility
+);
+void render_backend_end_frame(struct RenderBackend* backend);
+int render_backend_read_key(struct RenderBackend* backend, int timeout_ms);
+void render_backend_close(struct RenderBackend* backend);
+void render_backend_begin_byte_count(struct RenderBackend* backend);
+void render_backend_end_byte_count(struct RenderBackend* backend);
+void render_backend_add_bytes(struct RenderBackend* backend, long bytes);
+char render_backend_glyph_as_ascii(int c);
+
+
+#endif
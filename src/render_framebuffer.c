@@ -0,0 +1,153 @@
+#include "render_framebuffer.h"
+
+
+void render_framebuffer_get_size(struct RenderBackend* backend, int* width, int* height) {
+  struct RenderFramebuffer* framebuffer = backend->data;
+  *width = framebuffer->width;
+  *height = framebuffer->height;
+}
+
+
+void render_framebuffer_resize(struct RenderBackend* backend) {
+}
+
+
+void render_framebuffer_set(
+    struct RenderBackend* backend,
+    int window_id,
+    int y,
+    int x,
+    int c
+) {
+  struct RenderFramebuffer* framebuffer = backend->data;
+  if (window_id != RENDER_BACKEND_SCREEN) {
+    // Clip to the window like ncurses does.
+    if (x < 0 || x >= framebuffer->window_width[window_id]) return;
+    if (y < 0 || y >= framebuffer->window_height[window_id]) return;
+    x += framebuffer->left[window_id];
+    y += framebuffer->top[window_id];
+  }
+  if (x < 0 || x >= framebuffer->width || y < 0 || y >= framebuffer->height) return;
+  framebuffer->cells[y][x] = render_backend_glyph_as_ascii(c);
+  render_backend_add_bytes(backend, 1);
+}
+
+
+void render_framebuffer_begin_frame(struct RenderBackend* backend) {
+  struct RenderFramebuffer* framebuffer = backend->data;
+  for (int y = 0; y < framebuffer->height; y++) {
+    memset(framebuffer->cells[y], ' ', framebuffer->width);
+  }
+}
+
+
+void render_framebuffer_open_window(
+    struct RenderBackend* backend,
+    int window_id,
+    int left,
+    int top,
+    int width,
+    int height
+) {
+  struct RenderFramebuffer* framebuffer = backend->data;
+  framebuffer->left[window_id] = left;
+  framebuffer->top[window_id] = top;
+  framebuffer->window_width[window_id] = width;
+  framebuffer->window_height[window_id] = height;
+
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      int c = ' ';
+      if (y == 0 || y == height - 1) c = RENDER_GLYPH_HLINE;
+      if (x == 0 || x == width - 1) c = RENDER_GLYPH_VLINE;
+      if (y == 0 && x == 0) c = RENDER_GLYPH_ULCORNER;
+      if (y == 0 && x == width - 1) c = RENDER_GLYPH_URCORNER;
+      if (y == height - 1 && x == 0) c = RENDER_GLYPH_LLCORNER;
+      if (y == height - 1 && x == width - 1) c = RENDER_GLYPH_LRCORNER;
+      render_framebuffer_set(backend, window_id, y, x, c);
+    }
+  }
+}
+
+
+void render_framebuffer_put_string(
+    struct RenderBackend* backend,
+    int window_id,
+    int y,
+    int x,
+    const char* text
+) {
+  for (int i = 0; text[i] != '\0'; i++) {
+    render_framebuffer_set(backend, window_id, y, x + i, text[i]);
+  }
+}
+
+
+void render_framebuffer_set_cursor(
+    struct RenderBackend* backend,
+    int y,
+    int x,
+    enum CursorVisibility visibility
+) {
+  struct RenderFramebuffer* framebuffer = backend->data;
+  framebuffer->cursor_y = y;
+  framebuffer->cursor_x = x;
+  framebuffer->cursor_visibility = visibility;
+}
+
+
+void render_framebuffer_end_frame(struct RenderBackend* backend) {
+}
+
+
+int render_framebuffer_read_key(struct RenderBackend* backend, int timeout_ms) {
+  return RENDER_BACKEND_NO_KEY;
+}
+
+
+void render_framebuffer_close(struct RenderBackend* backend) {
+}
+
+
+void render_framebuffer_init(
+    struct RenderBackend* backend,
+    struct RenderFramebuffer* framebuffer,
+    int width,
+    int height
+) {
+  render_backend_init(backend, "framebuffer", framebuffer);
+  backend->get_size = render_framebuffer_get_size;
+  backend->resize = render_framebuffer_resize;
+  backend->begin_frame = render_framebuffer_begin_frame;
+  backend->open_window = render_framebuffer_open_window;
+  backend->put_char = render_framebuffer_set;
+  backend->put_string = render_framebuffer_put_string;
+  backend->set_cursor = render_framebuffer_set_cursor;
+  backend->end_frame = render_framebuffer_end_frame;
+  backend->read_key = render_framebuffer_read_key;
+  backend->close = render_framebuffer_close;
+
+  framebuffer->width = imin(width, RENDER_FRAMEBUFFER_WIDTH_MAX);
+  framebuffer->height = imin(height, RENDER_FRAMEBUFFER_HEIGHT_MAX);
+  framebuffer->cursor_y = 0;
+  framebuffer->cursor_x = 0;
+  framebuffer->cursor_visibility = CURSOR_VISIBILITY_NORMAL;
+  for (int i = 0; i < WINDOW_ID_MAX; i++) {
+    framebuffer->left[i] = 0;
+    framebuffer->top[i] = 0;
+    framebuffer->window_width[i] = 0;
+    framebuffer->window_height[i] = 0;
+  }
+  render_framebuffer_begin_frame(backend);
+}
+
+
+/**
+ * Print the last frame, one line per terminal row.
+ */
+void render_framebuffer_dump(struct RenderFramebuffer* framebuffer, FILE* file) {
+  for (int y = 0; y < framebuffer->height; y++) {
+    fwrite(framebuffer->cells[y], 1, framebuffer->width, file);
+    fputc('\n', file);
+  }
+}
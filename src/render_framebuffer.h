@@ -0,0 +1,42 @@
+#ifndef RENDER_FRAMEBUFFER_H
+#define RENDER_FRAMEBUFFER_H
+
+
+#include <stdio.h>
+#include "render_backend.h"
+#include "window_manager.h"
+#include "util.h"
+
+
+#define RENDER_FRAMEBUFFER_WIDTH_MAX 256
+#define RENDER_FRAMEBUFFER_HEIGHT_MAX 128
+
+
+/**
+ * Headless render backend writing ASCII cells into memory.
+ * Used to benchmark rendering and to compare frames without a tty.
+ */
+struct RenderFramebuffer {
+  int width;
+  int height;
+  char cells[RENDER_FRAMEBUFFER_HEIGHT_MAX][RENDER_FRAMEBUFFER_WIDTH_MAX];
+  int left[WINDOW_ID_MAX];
+  int top[WINDOW_ID_MAX];
+  int window_width[WINDOW_ID_MAX];
+  int window_height[WINDOW_ID_MAX];
+  int cursor_y;
+  int cursor_x;
+  enum CursorVisibility cursor_visibility;
+};
+
+
+void render_framebuffer_init(
+    struct RenderBackend* backend,
+    struct RenderFramebuffer* framebuffer,
+    int width,
+    int height
+);
+void render_framebuffer_dump(struct RenderFramebuffer* framebuffer, FILE* file);
+
+
+#endif
@@ -0,0 +1,201 @@
+#include "render_ncurses.h"
+
+
+chtype render_ncurses_glyph(int c) {
+  switch (c) {
+    case RENDER_GLYPH_ULCORNER: return ACS_ULCORNER;
+    case RENDER_GLYPH_URCORNER: return ACS_URCORNER;
+    case RENDER_GLYPH_LLCORNER: return ACS_LLCORNER;
+    case RENDER_GLYPH_LRCORNER: return ACS_LRCORNER;
+    case RENDER_GLYPH_HLINE: return ACS_HLINE;
+    case RENDER_GLYPH_VLINE: return ACS_VLINE;
+    case RENDER_GLYPH_CKBOARD: return ACS_CKBOARD;
+    case RENDER_GLYPH_BOARD: return ACS_BOARD;
+    case RENDER_GLYPH_BULLET: return ACS_BULLET;
+    default: return (chtype)c;
+  }
+}
+
+
+WINDOW* render_ncurses_get_window(struct RenderNcurses* ncurses, int window_id) {
+  if (window_id == RENDER_BACKEND_SCREEN) return stdscr;
+  return ncurses->window[window_id];
+}
+
+
+void render_ncurses_get_size(struct RenderBackend* backend, int* width, int* height) {
+  getmaxyx(stdscr, *height, *width);
+}
+
+
+/**
+ * SIGWINCH is handled by the event loop, not by ncurses, so the new size
+ * has to be given to ncurses.
+ */
+void render_ncurses_resize(struct RenderBackend* backend) {
+  struct winsize ws;
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0) {
+    resizeterm(ws.ws_row, ws.ws_col);
+  }
+}
+
+
+void render_ncurses_begin_frame(struct RenderBackend* backend) {
+  struct RenderNcurses* ncurses = backend->data;
+  erase();
+  for (int i = 0; i < WINDOW_ID_MAX; i++) {
+    werase(ncurses->window[i]);
+    ncurses->enable[i] = false;
+  }
+}
+
+
+void render_ncurses_open_window(
+    struct RenderBackend* backend,
+    int window_id,
+    int left,
+    int top,
+    int width,
+    int height
+) {
+  struct RenderNcurses* ncurses = backend->data;
+  WINDOW* window = ncurses->window[window_id];
+  // Only touch the ncurses window when the layout changed.
+  if (ncurses->width[window_id] != width || ncurses->height[window_id] != height) {
+    wresize(window, height, width);
+    ncurses->width[window_id] = width;
+    ncurses->height[window_id] = height;
+  }
+  if (ncurses->left[window_id] != left || ncurses->top[window_id] != top) {
+    mvwin(window, top, left);
+    ncurses->left[window_id] = left;
+    ncurses->top[window_id] = top;
+  }
+  box(window, 0, 0);
+  ncurses->enable[window_id] = true;
+}
+
+
+void render_ncurses_put_char(
+    struct RenderBackend* backend,
+    int window_id,
+    int y,
+    int x,
+    int c
+) {
+  WINDOW* window = render_ncurses_get_window(backend->data, window_id);
+  mvwaddch(window, y, x, render_ncurses_glyph(c));
+}
+
+
+void render_ncurses_put_string(
+    struct RenderBackend* backend,
+    int window_id,
+    int y,
+    int x,
+    const char* text
+) {
+  WINDOW* window = render_ncurses_get_window(backend->data, window_id);
+  mvwaddstr(window, y, x, text);
+}
+
+
+void render_ncurses_set_cursor(
+    struct RenderBackend* backend,
+    int y,
+    int x,
+    enum CursorVisibility visibility
+) {
+  struct RenderNcurses* ncurses = backend->data;
+  ncurses->cursor_y = y;
+  ncurses->cursor_x = x;
+  ncurses->cursor_visibility = visibility;
+}
+
+
+/**
+ * Bytes written so far by the drawing thread, or -1 when unknown.
+ * ncurses writes straight to the terminal file descriptor, so its output
+ * can not be counted on the way. The kernel counts it for us.
+ */
+long render_ncurses_get_written_bytes(struct RenderBackend* backend) {
+  struct RenderNcurses* ncurses = backend->data;
+  if (ncurses->io_fd == -1) return -1;
+  char io[512];
+  ssize_t size = pread(ncurses->io_fd, io, sizeof(io) - 1, 0);
+  if (size <= 0) return -1;
+  io[size] = '\0';
+  char* wchar = strstr(io, "wchar:");
+  return wchar == NULL ? -1 : atol(wchar + strlen("wchar:"));
+}
+
+
+/**
+ * Windows are drawn over `stdscr`, then `stdscr` is refreshed once more
+ * with no changes only to put the terminal cursor back on it.
+ */
+void render_ncurses_end_frame(struct RenderBackend* backend) {
+  struct RenderNcurses* ncurses = backend->data;
+  curs_set(ncurses->cursor_visibility);
+  wnoutrefresh(stdscr);
+  for (int i = 0; i < WINDOW_ID_MAX; i++) {
+    if (!ncurses->enable[i]) continue;
+    wnoutrefresh(ncurses->window[i]);
+  }
+  move(ncurses->cursor_y, ncurses->cursor_x);
+  wnoutrefresh(stdscr);
+  doupdate();
+}
+
+
+int render_ncurses_read_key(struct RenderBackend* backend, int timeout_ms) {
+  timeout(timeout_ms);
+  return getch();
+}
+
+
+void render_ncurses_close(struct RenderBackend* backend) {
+  struct RenderNcurses* ncurses = backend->data;
+  endwin();  // End ncurses.
+  if (ncurses->io_fd != -1) close(ncurses->io_fd);
+  ncurses->io_fd = -1;
+}
+
+
+void render_ncurses_init(struct RenderBackend* backend, struct RenderNcurses* ncurses) {
+  render_backend_init(backend, "ncurses", ncurses);
+  backend->get_size = render_ncurses_get_size;
+  backend->resize = render_ncurses_resize;
+  backend->begin_frame = render_ncurses_begin_frame;
+  backend->open_window = render_ncurses_open_window;
+  backend->put_char = render_ncurses_put_char;
+  backend->put_string = render_ncurses_put_string;
+  backend->set_cursor = render_ncurses_set_cursor;
+  backend->end_frame = render_ncurses_end_frame;
+  backend->read_key = render_ncurses_read_key;
+  backend->close = render_ncurses_close;
+  backend->get_written_bytes = render_ncurses_get_written_bytes;
+
+  initscr();
+  noecho();
+  cbreak();
+  keypad(stdscr, TRUE);
+  set_escdelay(25);
+
+  for (int i = 0; i < WINDOW_ID_MAX; i++) {
+    ncurses->window[i] = newwin(0, 0, 0, 0);
+    ncurses->enable[i] = false;
+    ncurses->left[i] = 0;
+    ncurses->top[i] = 0;
+    ncurses->width[i] = 0;
+    ncurses->height[i] = 0;
+  }
+  ncurses->cursor_y = 0;
+  ncurses->cursor_x = 0;
+  ncurses->cursor_visibility = CURSOR_VISIBILITY_NORMAL;
+
+  ncurses->io_fd = open(RENDER_NCURSES_IO_PATH, O_RDONLY | O_CLOEXEC);
+  if (ncurses->io_fd == -1) {
+    log_error_f("open(\"%s\") failed (%d): %s", RENDER_NCURSES_IO_PATH, errno, strerror(errno));
+  }
+}
@@ -0,0 +1,38 @@
+#ifndef RENDER_NCURSES_H
+#define RENDER_NCURSES_H
+
+
+#include <curses.h>
+#include <ncurses.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "render_backend.h"
+#include "window_manager.h"
+
+
+#define RENDER_NCURSES_IO_PATH "/proc/thread-self/io"
+
+
+/**
+ * Render backend drawing on `stdscr` with one ncurses window per overlay.
+ */
+struct RenderNcurses {
+  WINDOW* window[WINDOW_ID_MAX];
+  bool enable[WINDOW_ID_MAX];
+  int left[WINDOW_ID_MAX];
+  int top[WINDOW_ID_MAX];
+  int width[WINDOW_ID_MAX];
+  int height[WINDOW_ID_MAX];
+  int cursor_y;
+  int cursor_x;
+  enum CursorVisibility cursor_visibility;
+  // I/O counters of the drawing thread, -1 when the kernel has none.
+  int io_fd;
+};
+
+
+void render_ncurses_init(struct RenderBackend* backend, struct RenderNcurses* ncurses);
+
+
+#endif
@@ -0,0 +1,115 @@
+#include "reveal_animation.h"
+
+
+long reveal_animation_now_ms() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+
+void reveal_animation_init(struct RevealAnimation* reveal_animation) {
+  reveal_animation->count = 0;
+  reveal_animation->shown = 0;
+  reveal_animation->cells_per_frame = 1;
+  reveal_animation->next_frame_ms = 0;
+  reveal_animation->enable = false;
+  for (int i = 0; i < GAME_BOARD_INDEX_MAX; i++) {
+    reveal_animation->pending[i] = false;
+  }
+}
+
+
+void reveal_animation_toggle(struct RevealAnimation* reveal_animation) {
+  reveal_animation_stop(reveal_animation);
+  reveal_animation->enable = !reveal_animation->enable;
+  log_info_f("reveal_animation->enable=%s", boolean_as_string(reveal_animation->enable));
+}
+
+
+/**
+ * `cells` are the cells opened by the play, starting with the played cell.
+ * They are counting sorted by their distance to it so the wave spreads out
+ * from the click.
+ */
+void reveal_animation_start(
+    struct RevealAnimation* reveal_animation,
+    struct GameBoard* game_board,
+    const int* cells,
+    int count
+) {
+  reveal_animation_stop(reveal_animation);
+  if (!reveal_animation->enable || count <= 1) return;
+  log_info_f("reveal_animation_start(reveal_animation, game_board, cells, %d)", count);
+
+  int x = game_board_get_column(game_board, cells[0]);
+  int y = game_board_get_line(game_board, cells[0]);
+  int firsts[REVEAL_ANIMATION_DISTANCE_MAX + 1] = {0};
+  for (int i = 0; i < count; i++) {
+    int distance = abs(game_board_get_column(game_board, cells[i]) - x)
+      + abs(game_board_get_line(game_board, cells[i]) - y);
+    firsts[distance + 1]++;
+  }
+  for (int distance = 0; distance < REVEAL_ANIMATION_DISTANCE_MAX; distance++) {
+    firsts[distance + 1] += firsts[distance];
+  }
+  for (int i = 0; i < count; i++) {
+    int distance = abs(game_board_get_column(game_board, cells[i]) - x)
+      + abs(game_board_get_line(game_board, cells[i]) - y);
+    reveal_animation->cells[firsts[distance]++] = cells[i];
+    reveal_animation->pending[cells[i]] = true;
+  }
+  reveal_animation->count = count;
+  reveal_animation->shown = 0;
+  reveal_animation->cells_per_frame =
+    (count + REVEAL_ANIMATION_FRAME_COUNT - 1) / REVEAL_ANIMATION_FRAME_COUNT;
+  reveal_animation->next_frame_ms = reveal_animation_now_ms() + REVEAL_ANIMATION_FRAME_MS;
+}
+
+
+bool reveal_animation_is_running(struct RevealAnimation* reveal_animation) {
+  return reveal_animation->shown < reveal_animation->count;
+}
+
+
+bool reveal_animation_is_pending(struct RevealAnimation* reveal_animation, int i) {
+  return reveal_animation->pending[i];
+}
+
+
+/**
+ * Time to wait for a key before the next frame, -1 when not animating.
+ */
+int reveal_animation_get_timeout(struct RevealAnimation* reveal_animation) {
+  if (!reveal_animation_is_running(reveal_animation)) return -1;
+  long timeout = reveal_animation->next_frame_ms - reveal_animation_now_ms();
+  return timeout > 0 ? (int)timeout : 0;
+}
+
+
+/**
+ * Show the cells of every frame that is due. When frames were missed the
+ * wave catches up so it always ends on time.
+ */
+void reveal_animation_update(struct RevealAnimation* reveal_animation) {
+  long now = reveal_animation_now_ms();
+  if (now < reveal_animation->next_frame_ms) return;
+  long frames = 1 + (now - reveal_animation->next_frame_ms) / REVEAL_ANIMATION_FRAME_MS;
+  reveal_animation->next_frame_ms += frames * REVEAL_ANIMATION_FRAME_MS;
+
+  int shown = reveal_animation->shown + frames * reveal_animation->cells_per_frame;
+  shown = imin(shown, reveal_animation->count);
+  for (int i = reveal_animation->shown; i < shown; i++) {
+    reveal_animation->pending[reveal_animation->cells[i]] = false;
+  }
+  reveal_animation->shown = shown;
+}
+
+
+void reveal_animation_stop(struct RevealAnimation* reveal_animation) {
+  for (int i = reveal_animation->shown; i < reveal_animation->count; i++) {
+    reveal_animation->pending[reveal_animation->cells[i]] = false;
+  }
+  reveal_animation->count = 0;
+  reveal_animation->shown = 0;
+}
@@ -0,0 +1,47 @@
+#ifndef REVEAL_ANIMATION_H
+#define REVEAL_ANIMATION_H
+
+
+#include <stdbool.h>
+#include <time.h>
+#include "game_board.h"
+
+
+#define REVEAL_ANIMATION_FRAME_MS 16
+#define REVEAL_ANIMATION_FRAME_COUNT 12
+#define REVEAL_ANIMATION_DISTANCE_MAX (GAME_BOARD_WIDTH_MAX + GAME_BOARD_HEIGHT_MAX)
+
+
+/**
+ * Shows the cells opened by one play over a few frames, nearest to the
+ * played cell first.
+ * The game board is already revealed, the animation only hides the cells
+ * that are still pending from the renderer.
+ */
+struct RevealAnimation {
+  int cells[GAME_BOARD_SIZE_MAX];
+  bool pending[GAME_BOARD_INDEX_MAX];
+  int count;
+  int shown;
+  int cells_per_frame;
+  long next_frame_ms;
+  bool enable;
+};
+
+
+void reveal_animation_init(struct RevealAnimation* reveal_animation);
+void reveal_animation_toggle(struct RevealAnimation* reveal_animation);
+void reveal_animation_start(
+    struct RevealAnimation* reveal_animation,
+    struct GameBoard* game_board,
+    const int* cells,
+    int count
+);
+bool reveal_animation_is_running(struct RevealAnimation* reveal_animation);
+bool reveal_animation_is_pending(struct RevealAnimation* reveal_animation, int i);
+int reveal_animation_get_timeout(struct RevealAnimation* reveal_animation);
+void reveal_animation_update(struct RevealAnimation* reveal_animation);
+void reveal_animation_stop(struct RevealAnimation* reveal_animation);
+
+
+#endif
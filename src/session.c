@@ -0,0 +1,71 @@
+#include "session.h"
+
+
+void session_table_init(struct SessionTable* session_table) {
+  for (int i = 0; i < SESSION_MAX; i++) {
+    struct Session* session = &session_table->sessions[i];
+    session->is_open = false;
+    session->arena.base = NULL;
+    session->game_board = NULL;
+    session->delta = NULL;
+  }
+  session_table->open_count = 0;
+}
+
+
+void session_open(struct Session* session) {
+  if (session->arena.base == NULL) arena_init(&session->arena, SESSION_ARENA_SIZE);
+  session->game_board = arena_allocate(
+      &session->arena,
+      sizeof(struct GameBoard),
+      _Alignof(struct GameBoard)
+  );
+  session->delta = arena_allocate(
+      &session->arena,
+      sizeof(struct GameBoardDelta),
+      _Alignof(struct GameBoardDelta)
+  );
+  // Every command but `new` fails until a board exists.
+  game_board_init(session->game_board, 0, 0);
+  game_board_delta_clear(session->delta);
+  session->is_open = true;
+}
+
+
+/**
+ * Return the session with this id, starting it when it is not open yet.
+ * NULL when the id is out of range.
+ */
+struct Session* session_table_open(struct SessionTable* session_table, int id) {
+  if (id < 0 || id >= SESSION_MAX) return NULL;
+  struct Session* session = &session_table->sessions[id];
+  if (!session->is_open) {
+    session_open(session);
+    session_table->open_count++;
+  }
+  return session;
+}
+
+
+/**
+ * End a session and give its memory back. False when it was not open.
+ */
+bool session_table_end(struct SessionTable* session_table, int id) {
+  if (id < 0 || id >= SESSION_MAX) return false;
+  struct Session* session = &session_table->sessions[id];
+  if (!session->is_open) return false;
+  arena_reset(&session->arena);
+  session->is_open = false;
+  session->game_board = NULL;
+  session->delta = NULL;
+  session_table->open_count--;
+  return true;
+}
+
+
+void session_table_close(struct SessionTable* session_table) {
+  for (int i = 0; i < SESSION_MAX; i++) {
+    session_table_end(session_table, i);
+    arena_close(&session_table->sessions[i].arena);
+  }
+}
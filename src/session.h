@@ -0,0 +1,49 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+
+#include <stdbool.h>
+#include "arena.h"
+#include "game_board.h"
+
+
+#define SESSION_MAX 4096
+// Room for a board and its delta, rounded up to whole pages.
+#define SESSION_ARENA_SIZE (64 * 1024)
+_Static_assert(
+    sizeof(struct GameBoard) + _Alignof(struct GameBoardDelta) + sizeof(struct GameBoardDelta)
+        <= SESSION_ARENA_SIZE,
+    "A board and its delta must fit in SESSION_ARENA_SIZE."
+);
+
+
+/**
+ * One independent game hosted by the process. Its board and delta live in
+ * the session's own arena, so ending the session frees them in O(1) and an
+ * idle session only holds the pages its board size touched.
+ */
+struct Session {
+  bool is_open;
+  struct Arena arena;
+  struct GameBoard* game_board;
+  struct GameBoardDelta* delta;
+};
+
+
+/**
+ * Sessions by id. Arenas are mapped the first time their id is used and
+ * kept, empty, when the session ends.
+ */
+struct SessionTable {
+  struct Session sessions[SESSION_MAX];
+  int open_count;
+};
+
+
+void session_table_init(struct SessionTable* session_table);
+struct Session* session_table_open(struct SessionTable* session_table, int id);
+bool session_table_end(struct SessionTable* session_table, int id);
+void session_table_close(struct SessionTable* session_table);
+
+
+#endif
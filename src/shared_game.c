@@ -0,0 +1,199 @@
+#include "shared_game.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+
+// The consistent copy printed by `shared_game_print`.
+struct SharedGameData g_shared_game_snapshot;
+
+
+void shared_game_init(struct SharedGame* shared_game) {
+  shared_game->data = NULL;
+  shared_game->name[0] = '\0';
+}
+
+
+/**
+ * Create the segment when $MINESWEEPER_SHARED_MEMORY names it.
+ */
+void shared_game_open_user_segment(struct SharedGame* shared_game) {
+  const char* name = getenv(SHARED_GAME_NAME_ENV);
+  if (name == NULL) return;
+  if (strlen(name) >= SHARED_GAME_NAME_MAX) {
+    log_fatal_f("Shared memory name is too long: %s\n", name);
+  }
+
+  int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+  if (fd == -1) {
+    log_fatal_f("shm_open(\"%s\") failed (%d): %s\n", name, errno, strerror(errno));
+  }
+  if (ftruncate(fd, sizeof(struct SharedGameData)) == -1) {
+    log_fatal_f("ftruncate() failed (%d): %s\n", errno, strerror(errno));
+  }
+  void* data = mmap(NULL, sizeof(struct SharedGameData), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    log_fatal_f("mmap() failed (%d): %s\n", errno, strerror(errno));
+  }
+  close(fd);
+
+  shared_game->data = data;
+  strcpy(shared_game->name, name);
+  // Odd until the first update so readers wait for a complete game.
+  atomic_store_explicit(&shared_game->data->sequence, 1, memory_order_relaxed);
+  memcpy(shared_game->data->magic, SHARED_GAME_MAGIC, sizeof(shared_game->data->magic));
+  log_info_f("Publishing the game to shared memory %s", name);
+}
+
+
+// The segment keeps the cells without the border of the game board.
+void shared_game_copy_cell(struct SharedGameData* data, struct GameBoard* game_board, int index) {
+  int i = game_board_get_line(game_board, index) * game_board->width
+    + game_board_get_column(game_board, index);
+  data->board[i] = game_board->board[index];
+  data->visibility_map[i] = game_board->visibility_map[index];
+  data->markers[i] = game_board->markers[index];
+}
+
+
+/**
+ * Write the game between two sequence increments. Only the cells of the
+ * game delta are copied, so this must run before the render clears it.
+ */
+void shared_game_publish(struct SharedGame* shared_game, struct Game* game) {
+  struct SharedGameData* data = shared_game->data;
+  if (data == NULL) return;
+  struct GameBoard* game_board = &game->game_board;
+  struct GameBoardDelta* delta = &game->delta;
+
+  unsigned int sequence = atomic_load_explicit(&data->sequence, memory_order_relaxed) | 1;
+  atomic_store_explicit(&data->sequence, sequence, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  data->width = game_board->width;
+  data->height = game_board->height;
+  data->cursor_x = game->cursor.x;
+  data->cursor_y = game->cursor.y;
+  data->game_state = game->game_state;
+  if (delta->overflow) {
+    for (int y = 0; y < game_board->height; y++) {
+      for (int x = 0; x < game_board->width; x++) {
+        shared_game_copy_cell(data, game_board, game_board_get_index(game_board, x, y));
+      }
+    }
+  } else {
+    for (int i = 0; i < delta->count; i++) {
+      shared_game_copy_cell(data, game_board, delta->cells[i]);
+    }
+  }
+
+  atomic_store_explicit(&data->sequence, sequence + 1, memory_order_release);
+}
+
+
+void shared_game_close(struct SharedGame* shared_game) {
+  if (shared_game->data == NULL) return;
+  munmap(shared_game->data, sizeof(struct SharedGameData));
+  shm_unlink(shared_game->name);
+  shared_game->data = NULL;
+}
+
+
+/**
+ * Map a published game read only, NULL when there is none.
+ */
+const struct SharedGameData* shared_game_map_reader(const char* name) {
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd == -1) {
+    log_error_f("shm_open(\"%s\") failed (%d): %s", name, errno, strerror(errno));
+    return NULL;
+  }
+  void* data = mmap(NULL, sizeof(struct SharedGameData), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    log_error_f("mmap() failed (%d): %s", errno, strerror(errno));
+    return NULL;
+  }
+  if (memcmp(((struct SharedGameData*)data)->magic, SHARED_GAME_MAGIC, 8) != 0) {
+    log_error_f("%s is not a published game", name);
+    munmap(data, sizeof(struct SharedGameData));
+    return NULL;
+  }
+  return data;
+}
+
+
+unsigned int shared_game_read_begin(const struct SharedGameData* data) {
+  return atomic_load_explicit(
+      (atomic_uint*)&data->sequence,
+      memory_order_acquire
+  );
+}
+
+
+/**
+ * True when the game was being written during the read, which must then
+ * be done again.
+ */
+bool shared_game_read_retry(const struct SharedGameData* data, unsigned int sequence) {
+  atomic_thread_fence(memory_order_acquire);
+  unsigned int current = atomic_load_explicit(
+      (atomic_uint*)&data->sequence,
+      memory_order_relaxed
+  );
+  return (sequence & 1) != 0 || current != sequence;
+}
+
+
+void shared_game_unmap_reader(const struct SharedGameData* data) {
+  munmap((void*)data, sizeof(struct SharedGameData));
+}
+
+
+/**
+ * Print one consistent snapshot of a published game, as a reader example.
+ */
+bool shared_game_print(const char* name, FILE* file) {
+  const struct SharedGameData* data = shared_game_map_reader(name);
+  if (data == NULL) return false;
+
+  struct SharedGameData* snapshot = &g_shared_game_snapshot;
+  unsigned int sequence;
+  int retry_count = -1;
+  do {
+    retry_count++;
+    sequence = shared_game_read_begin(data);
+    memcpy(snapshot, data, sizeof(*snapshot));
+  } while (shared_game_read_retry(data, sequence));
+  shared_game_unmap_reader(data);
+
+  fprintf(
+      file,
+      "sequence=%u retries=%d size=%dx%d cursor=%d,%d game_state=%d\n",
+      sequence,
+      retry_count,
+      snapshot->width,
+      snapshot->height,
+      snapshot->cursor_x,
+      snapshot->cursor_y,
+      snapshot->game_state
+  );
+  for (int y = 0; y < snapshot->height; y++) {
+    for (int x = 0; x < snapshot->width; x++) {
+      int i = y * snapshot->width + x;
+      char glyph = '#';
+      if (snapshot->visibility_map[i]) {
+        char cell = snapshot->board[i];
+        glyph = cell == BOARD_CELL_TYPE_EMPTY ? '.' : cell == BOARD_CELL_TYPE_MINE ? '*' : '0' + cell;
+      } else if (
+        snapshot->markers[i] == BOARD_CELL_TYPE_MINE_MARKER
+        || snapshot->markers[i] == BOARD_CELL_TYPE_OK_MARKER
+      ) {
+        glyph = snapshot->markers[i];
+      }
+      fputc(glyph, file);
+    }
+    fputc('\n', file);
+  }
+  return true;
+}
@@ -0,0 +1,65 @@
+#ifndef SHARED_GAME_H
+#define SHARED_GAME_H
+
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "game.h"
+
+
+#define SHARED_GAME_NAME_ENV "MINESWEEPER_SHARED_MEMORY"
+#define SHARED_GAME_MAGIC "MSSHARE1"
+#define SHARED_GAME_NAME_MAX 256
+
+
+/**
+ * The game as laid out in the shared memory segment. Tools in other
+ * processes map it read only and read it in place, guarded by `sequence`:
+ *
+ *   uint32_t sequence;
+ *   do {
+ *     sequence = shared_game_read_begin(data);
+ *     ... read the fields ...
+ *   } while (shared_game_read_retry(data, sequence));
+ *
+ * Readers never block the game and a read costs no system call.
+ */
+struct SharedGameData {
+  char magic[8];
+  // Odd while the game is writing, increased by 2 on every update.
+  atomic_uint sequence;
+  int32_t width;
+  int32_t height;
+  int32_t cursor_x;
+  int32_t cursor_y;
+  // An `enum GameState`.
+  int32_t game_state;
+  char board[GAME_BOARD_SIZE_MAX];
+  bool visibility_map[GAME_BOARD_SIZE_MAX];
+  char markers[GAME_BOARD_SIZE_MAX];
+};
+
+
+/**
+ * Publishes the game to the POSIX shared memory object named by
+ * $MINESWEEPER_SHARED_MEMORY, e.g. "/minesweeper".
+ */
+struct SharedGame {
+  struct SharedGameData* data;
+  char name[SHARED_GAME_NAME_MAX];
+};
+
+
+void shared_game_init(struct SharedGame* shared_game);
+void shared_game_open_user_segment(struct SharedGame* shared_game);
+void shared_game_publish(struct SharedGame* shared_game, struct Game* game);
+void shared_game_close(struct SharedGame* shared_game);
+const struct SharedGameData* shared_game_map_reader(const char* name);
+unsigned int shared_game_read_begin(const struct SharedGameData* data);
+bool shared_game_read_retry(const struct SharedGameData* data, unsigned int sequence);
+void shared_game_unmap_reader(const struct SharedGameData* data);
+bool shared_game_print(const char* name, FILE* file);
+
+
+#endif
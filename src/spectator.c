@@ -0,0 +1,251 @@
+#include "spectator.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+
+void spectator_init(struct Spectator* spectator) {
+  spectator->listen_fd = -1;
+  spectator->path[0] = '\0';
+  spectator->status = COMMAND_STREAM_STATUS_PLAYING;
+  spectator->is_pending = false;
+  spectator->client_count = 0;
+  spectator->message_size = 0;
+}
+
+
+/**
+ * Listen for spectators when $MINESWEEPER_SPECTATE names the socket.
+ */
+void spectator_open_user_socket(struct Spectator* spectator) {
+  const char* path = getenv(SPECTATOR_SOCKET_ENV);
+  if (path == NULL) return;
+
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(address.sun_path)) {
+    log_fatal_f("Spectator socket path is too long: %s\n", path);
+  }
+  strcpy(address.sun_path, path);
+  strcpy(spectator->path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd == -1) {
+    log_fatal_f("socket() failed (%d): %s\n", errno, strerror(errno));
+  }
+  // A socket left behind by a previous run would make bind fail.
+  unlink(path);
+  if (bind(fd, (struct sockaddr*)&address, sizeof(address)) == -1) {
+    log_fatal_f("bind(\"%s\") failed (%d): %s\n", path, errno, strerror(errno));
+  }
+  if (listen(fd, SOMAXCONN) == -1) {
+    log_fatal_f("listen() failed (%d): %s\n", errno, strerror(errno));
+  }
+  spectator->listen_fd = fd;
+  log_info_f("Spectators can connect to %s", path);
+}
+
+
+void spectator_remove_client(struct Spectator* spectator, int client_i) {
+  close(spectator->clients[client_i].fd);
+  spectator->client_count--;
+  if (client_i != spectator->client_count) {
+    spectator->clients[client_i] = spectator->clients[spectator->client_count];
+  }
+  log_info_f("Spectator left, %d left watching", spectator->client_count);
+}
+
+
+/**
+ * Take every pending connection. New clients get a snapshot on the next
+ * flush.
+ */
+void spectator_accept(struct Spectator* spectator) {
+  int fd;
+  while ((fd = accept(spectator->listen_fd, NULL, NULL)) != -1) {
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    if (spectator->client_count == SPECTATOR_CLIENT_MAX) {
+      log_error_f("Spectator refused, already %d spectators", SPECTATOR_CLIENT_MAX);
+      close(fd);
+      continue;
+    }
+    struct SpectatorClient* client = &spectator->clients[spectator->client_count++];
+    client->fd = fd;
+    client->needs_snapshot = true;
+    client->output_start = 0;
+    client->output_end = 0;
+    spectator->is_pending = true;
+    log_info_f("Spectator joined, %d watching", spectator->client_count);
+  }
+  if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+    log_error_f("accept() failed (%d): %s", errno, strerror(errno));
+  }
+}
+
+
+int spectator_get_snapshot_size(struct GameBoard* game_board) {
+  return 32 + game_board->height * (game_board->width + 1);
+}
+
+
+void spectator_encode_snapshot(struct Spectator* spectator, struct GameBoard* game_board) {
+  char* output = spectator->message;
+  output += sprintf(
+      output,
+      "s %d %d %c\n",
+      game_board->width,
+      game_board->height,
+      spectator->status
+  );
+  for (int y = 0; y < game_board->height; y++) {
+    for (int x = 0; x < game_board->width; x++) {
+      *output++ = command_stream_get_glyph(game_board, game_board_get_index(game_board, x, y));
+    }
+    *output++ = '\n';
+  }
+  spectator->message_size = output - spectator->message;
+}
+
+
+void spectator_encode_delta(
+    struct Spectator* spectator,
+    struct GameBoard* game_board,
+    struct GameBoardDelta* delta
+) {
+  char* output = spectator->message;
+  *output++ = spectator->status;
+  for (int i = 0; i < delta->count; i++) {
+    int index = delta->cells[i];
+    *output++ = ' ';
+    output = command_stream_format_int(output, game_board_get_column(game_board, index));
+    *output++ = ',';
+    output = command_stream_format_int(output, game_board_get_line(game_board, index));
+    *output++ = ',';
+    *output++ = command_stream_get_glyph(game_board, index);
+  }
+  *output++ = '\n';
+  spectator->message_size = output - spectator->message;
+}
+
+
+/**
+ * Queue the message for a client. When it does not fit the client is
+ * behind, and skips to a snapshot once its buffer has drained.
+ */
+void spectator_client_append(
+    struct SpectatorClient* client,
+    const char* message,
+    int message_size
+) {
+  if (client->needs_snapshot) return;
+  if (client->output_end + message_size > SPECTATOR_BUFFER_SIZE && client->output_start > 0) {
+    memmove(
+        client->output,
+        client->output + client->output_start,
+        client->output_end - client->output_start
+    );
+    client->output_end -= client->output_start;
+    client->output_start = 0;
+  }
+  if (client->output_end + message_size > SPECTATOR_BUFFER_SIZE) {
+    client->needs_snapshot = true;
+    return;
+  }
+  memcpy(client->output + client->output_end, message, message_size);
+  client->output_end += message_size;
+}
+
+
+/**
+ * Queue the cells changed since the last update for every client. Must run
+ * before the delta is cleared by the render.
+ */
+void spectator_publish(
+    struct Spectator* spectator,
+    struct GameBoard* game_board,
+    struct GameBoardDelta* delta
+) {
+  enum CommandStreamStatus status = command_stream_get_status(game_board);
+  if (!delta->overflow && delta->count == 0 && status == spectator->status) return;
+  spectator->status = status;
+  if (spectator->client_count == 0) return;
+
+  int snapshot_size = spectator_get_snapshot_size(game_board);
+  if (delta->overflow || 2 + delta->count * SPECTATOR_CELL_SIZE > snapshot_size) {
+    spectator_encode_snapshot(spectator, game_board);
+  } else {
+    spectator_encode_delta(spectator, game_board, delta);
+  }
+  for (int i = 0; i < spectator->client_count; i++) {
+    spectator_client_append(&spectator->clients[i], spectator->message, spectator->message_size);
+  }
+  spectator->is_pending = true;
+}
+
+
+/**
+ * Write what each client's socket takes without blocking. Clients that
+ * went away are removed.
+ */
+void spectator_flush(struct Spectator* spectator, struct GameBoard* game_board) {
+  if (!spectator->is_pending) return;
+  spectator->is_pending = false;
+  bool is_snapshot_encoded = false;
+  int client_i = 0;
+  while (client_i < spectator->client_count) {
+    struct SpectatorClient* client = &spectator->clients[client_i];
+    if (client->needs_snapshot && client->output_start == client->output_end) {
+      if (!is_snapshot_encoded) {
+        spectator_encode_snapshot(spectator, game_board);
+        is_snapshot_encoded = true;
+      }
+      client->needs_snapshot = false;
+      client->output_start = 0;
+      client->output_end = 0;
+      spectator_client_append(client, spectator->message, spectator->message_size);
+    }
+
+    if (client->output_start < client->output_end) {
+      ssize_t result = send(
+          client->fd,
+          client->output + client->output_start,
+          client->output_end - client->output_start,
+          MSG_NOSIGNAL | MSG_DONTWAIT
+      );
+      if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        spectator_remove_client(spectator, client_i);
+        continue;
+      }
+      if (result > 0) client->output_start += result;
+      if (client->output_start == client->output_end) {
+        client->output_start = 0;
+        client->output_end = 0;
+      }
+    }
+
+    if (client->output_start < client->output_end || client->needs_snapshot) {
+      spectator->is_pending = true;
+    }
+    client_i++;
+  }
+}
+
+
+/**
+ * Time until the next flush attempt, -1 when everything was written.
+ */
+int spectator_get_timeout(struct Spectator* spectator) {
+  return spectator->is_pending ? SPECTATOR_RETRY_MS : -1;
+}
+
+
+void spectator_close(struct Spectator* spectator) {
+  if (spectator->listen_fd == -1) return;
+  while (spectator->client_count > 0) {
+    spectator_remove_client(spectator, spectator->client_count - 1);
+  }
+  close(spectator->listen_fd);
+  unlink(spectator->path);
+  spectator->listen_fd = -1;
+}
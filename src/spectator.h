@@ -0,0 +1,74 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+
+#include <stdbool.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "game_board.h"
+#include "command_stream.h"
+
+
+#define SPECTATOR_SOCKET_ENV "MINESWEEPER_SPECTATE"
+#define SPECTATOR_CLIENT_MAX 256
+#define SPECTATOR_BUFFER_SIZE (16 * 1024)
+// Header line, then one line per row.
+#define SPECTATOR_SNAPSHOT_MAX (32 + GAME_BOARD_HEIGHT_MAX * (GAME_BOARD_WIDTH_MAX + 1))
+// Status and line feed, then " xx,yy,c" per cell.
+#define SPECTATOR_CELL_SIZE 8
+// How soon to retry clients whose socket was full.
+#define SPECTATOR_RETRY_MS 20
+
+
+/**
+ * One connected spectator. Output waits in the buffer until the socket
+ * takes it. A client too slow to keep up stops receiving updates and gets
+ * a fresh snapshot once its buffer has drained.
+ */
+struct SpectatorClient {
+  int fd;
+  bool needs_snapshot;
+  int output_start;
+  int output_end;
+  char output[SPECTATOR_BUFFER_SIZE];
+};
+
+
+/**
+ * Streams the game to spectators connected on the UNIX socket named by
+ * $MINESWEEPER_SPECTATE, in the command stream text format:
+ *   s <width> <height> <status>  a snapshot, then one line of glyphs per row
+ *   <status> x,y,c ...           the cells changed since the previous update
+ * A client first gets a snapshot, and gets one again whenever the whole
+ * board changed or a snapshot is smaller than the changes.
+ * Sockets are non blocking and written once per loop iteration, so a slow
+ * spectator never stalls the game.
+ */
+struct Spectator {
+  int listen_fd;
+  char path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+  enum CommandStreamStatus status;
+  // Some client still has output or a snapshot to send.
+  bool is_pending;
+  int client_count;
+  struct SpectatorClient clients[SPECTATOR_CLIENT_MAX];
+  // Each update is encoded once, then copied to every client.
+  char message[SPECTATOR_SNAPSHOT_MAX];
+  int message_size;
+};
+
+
+void spectator_init(struct Spectator* spectator);
+void spectator_open_user_socket(struct Spectator* spectator);
+void spectator_accept(struct Spectator* spectator);
+void spectator_publish(
+    struct Spectator* spectator,
+    struct GameBoard* game_board,
+    struct GameBoardDelta* delta
+);
+void spectator_flush(struct Spectator* spectator, struct GameBoard* game_board);
+int spectator_get_timeout(struct Spectator* spectator);
+void spectator_close(struct Spectator* spectator);
+
+
+#endif
@@ -0,0 +1,324 @@
+#include "stats.h"
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+_Static_assert(sizeof(struct StatsRecord) == 32, "Log records are 32 bytes on disk.");
+
+
+struct StatsBoardSize {
+  int width;
+  int height;
+};
+
+
+// The board sizes offered by the menu, by difficulty.
+const struct StatsBoardSize g_stats_board_sizes[STATS_DIFFICULTY_CUSTOM] = {
+  [STATS_DIFFICULTY_EASY] = {GAME_BOARD_EASY_WIDTH, GAME_BOARD_EASY_HEIGHT},
+  [STATS_DIFFICULTY_MEDIUM] = {GAME_BOARD_MEDIUM_WIDTH, GAME_BOARD_MEDIUM_HEIGHT},
+  [STATS_DIFFICULTY_HARD] = {GAME_BOARD_HARD_WIDTH, GAME_BOARD_HARD_HEIGHT},
+};
+
+
+const char* g_stats_difficulty_names[STATS_DIFFICULTY_MAX] = {
+  [STATS_DIFFICULTY_EASY] = "Easy",
+  [STATS_DIFFICULTY_MEDIUM] = "Medium",
+  [STATS_DIFFICULTY_HARD] = "Hard",
+  [STATS_DIFFICULTY_CUSTOM] = "Custom",
+};
+
+
+void stats_init(struct Stats* stats) {
+  stats->log_fd = -1;
+  stats->index = NULL;
+  stats->difficulty = STATS_DIFFICULTY_EASY;
+}
+
+
+enum StatsDifficulty stats_get_difficulty(int width, int height) {
+  for (int i = 0; i < STATS_DIFFICULTY_CUSTOM; i++) {
+    if (g_stats_board_sizes[i].width == width && g_stats_board_sizes[i].height == height) {
+      return i;
+    }
+  }
+  return STATS_DIFFICULTY_CUSTOM;
+}
+
+
+const char* stats_get_difficulty_name(enum StatsDifficulty difficulty) {
+  return g_stats_difficulty_names[difficulty];
+}
+
+
+/**
+ * Ties keep the earlier game ahead.
+ */
+void stats_leaderboard_insert(struct StatsSummary* summary, const struct StatsRecord* record) {
+  int position = summary->leaderboard_size;
+  while (position > 0 && record->time_ms < summary->leaderboard[position - 1].time_ms) {
+    position--;
+  }
+  if (position == STATS_LEADERBOARD_SIZE) return;
+
+  int last = imin(summary->leaderboard_size, STATS_LEADERBOARD_SIZE - 1);
+  for (int i = last; i > position; i--) {
+    summary->leaderboard[i] = summary->leaderboard[i - 1];
+  }
+  struct StatsLeaderboardEntry* entry = &summary->leaderboard[position];
+  memset(entry, 0, sizeof(*entry));
+  entry->time_ms = record->time_ms;
+  entry->click_count = record->click_count;
+  entry->bbbv = record->bbbv;
+  entry->finished_at = record->finished_at;
+  if (summary->leaderboard_size < STATS_LEADERBOARD_SIZE) summary->leaderboard_size++;
+}
+
+
+void stats_index_fold(struct StatsIndex* index, const struct StatsRecord* record) {
+  int difficulty = record->difficulty < STATS_DIFFICULTY_MAX
+    ? record->difficulty
+    : STATS_DIFFICULTY_CUSTOM;
+  struct StatsSummary* summary = &index->summaries[difficulty];
+  summary->played_count++;
+  if (record->outcome == STATS_OUTCOME_WON) {
+    summary->won_count++;
+    summary->streak++;
+    if (summary->streak > summary->best_streak) summary->best_streak = summary->streak;
+    stats_leaderboard_insert(summary, record);
+  } else {
+    summary->streak = 0;
+  }
+  index->record_count++;
+}
+
+
+void stats_index_reset(struct StatsIndex* index) {
+  memset(index, 0, sizeof(*index));
+  memcpy(index->magic, STATS_INDEX_MAGIC, sizeof(index->magic));
+}
+
+
+/**
+ * Fold the records the index does not cover yet, from a read only mapping
+ * of the log.
+ */
+bool stats_index_catch_up(struct StatsIndex* index, int log_fd, uint64_t record_count) {
+  if (index->record_count == record_count) return true;
+  size_t size = sizeof(STATS_LOG_MAGIC) - 1 + record_count * sizeof(struct StatsRecord);
+  char* log = mmap(NULL, size, PROT_READ, MAP_PRIVATE, log_fd, 0);
+  if (log == MAP_FAILED) {
+    log_error_f("mmap() failed (%d): %s", errno, strerror(errno));
+    return false;
+  }
+  madvise(log, size, MADV_SEQUENTIAL);
+  const struct StatsRecord* records =
+    (const struct StatsRecord*)(log + sizeof(STATS_LOG_MAGIC) - 1);
+  log_info_f("Indexing %lu game records.", record_count - index->record_count);
+  for (uint64_t i = index->record_count; i < record_count; i++) {
+    stats_index_fold(index, &records[i]);
+  }
+  munmap(log, size);
+  return true;
+}
+
+
+bool stats_open_index(struct Stats* stats, const char* index_path, uint64_t record_count) {
+  int fd = open(index_path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    log_error_f("open(\"%s\") failed (%d): %s", index_path, errno, strerror(errno));
+    return false;
+  }
+  if (ftruncate(fd, sizeof(struct StatsIndex)) == -1) {
+    log_error_f("ftruncate() failed (%d): %s", errno, strerror(errno));
+    close(fd);
+    return false;
+  }
+  struct StatsIndex* index = mmap(
+      NULL,
+      sizeof(struct StatsIndex),
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED,
+      fd,
+      0
+  );
+  close(fd);
+  if (index == MAP_FAILED) {
+    log_error_f("mmap() failed (%d): %s", errno, strerror(errno));
+    return false;
+  }
+
+  bool is_valid = memcmp(index->magic, STATS_INDEX_MAGIC, sizeof(index->magic)) == 0
+    && index->record_count <= record_count;
+  if (!is_valid) stats_index_reset(index);
+  stats->index = index;
+  return stats_index_catch_up(index, stats->log_fd, record_count);
+}
+
+
+/**
+ * Open the log, creating it when needed, and its index. A record cut short
+ * by a crash is dropped.
+ */
+bool stats_open(struct Stats* stats, const char* log_path) {
+  int header_size = sizeof(STATS_LOG_MAGIC) - 1;
+  int fd = open(log_path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    log_error_f("open(\"%s\") failed (%d): %s", log_path, errno, strerror(errno));
+    return false;
+  }
+
+  struct stat status;
+  fstat(fd, &status);
+  if (status.st_size == 0) {
+    if (write(fd, STATS_LOG_MAGIC, header_size) != header_size) {
+      log_error_f("write() failed (%d): %s", errno, strerror(errno));
+      close(fd);
+      return false;
+    }
+    status.st_size = header_size;
+  }
+  char magic[sizeof(STATS_LOG_MAGIC) - 1];
+  if (pread(fd, magic, header_size, 0) != header_size
+      || memcmp(magic, STATS_LOG_MAGIC, header_size) != 0
+  ) {
+    log_error_f("%s is not a statistics file.", log_path);
+    close(fd);
+    return false;
+  }
+
+  uint64_t record_count = (status.st_size - header_size) / sizeof(struct StatsRecord);
+  off_t size = header_size + record_count * sizeof(struct StatsRecord);
+  if (size != status.st_size) {
+    log_error_f("Dropping a truncated record at the end of %s.", log_path);
+    // Appends after a partial record would misalign every later one.
+    if (ftruncate(fd, size) == -1) {
+      log_error_f("ftruncate() failed (%d): %s", errno, strerror(errno));
+      close(fd);
+      return false;
+    }
+  }
+  stats->log_fd = fd;
+
+  char index_path[STATS_PATH_MAX];
+  snprintf(index_path, sizeof(index_path), "%s%s", log_path, STATS_INDEX_SUFFIX);
+  if (!stats_open_index(stats, index_path, record_count)) {
+    stats_close(stats);
+    return false;
+  }
+  log_info_f("Statistics: %lu games in %s", record_count, log_path);
+  return true;
+}
+
+
+/**
+ * Open $MINESWEEPER_STATS, or ~/.minesweeper_stats.
+ */
+void stats_open_user_file(struct Stats* stats) {
+  const char* path = getenv(STATS_FILE_ENV);
+  if (path != NULL) {
+    stats_open(stats, path);
+    return;
+  }
+  const char* home = getenv("HOME");
+  if (home == NULL) return;
+  char home_path[STATS_PATH_MAX];
+  snprintf(home_path, sizeof(home_path), "%s/%s", home, STATS_FILE_NAME);
+  stats_open(stats, home_path);
+}
+
+
+/**
+ * Append the record to the log, then fold it into the index. A crash in
+ * between leaves the index behind, and it catches up on the next open.
+ */
+bool stats_append(struct Stats* stats, const struct StatsRecord* record) {
+  if (stats->log_fd == -1) return false;
+  if (write(stats->log_fd, record, sizeof(*record)) != sizeof(*record)) {
+    log_error_f("write() failed (%d): %s", errno, strerror(errno));
+    return false;
+  }
+  stats_index_fold(stats->index, record);
+  return true;
+}
+
+
+/**
+ * Record a game that just ended.
+ */
+void stats_record_game(struct Stats* stats, struct Game* game, long now_ms) {
+  if (stats->log_fd == -1) return;
+  struct GameBoard* game_board = &game->game_board;
+  struct StatsRecord record;
+  memset(&record, 0, sizeof(record));
+  record.finished_at = time(NULL);
+  record.seed = game->seed;
+  record.time_ms = game->start_ms > 0 ? now_ms - game->start_ms : 0;
+  record.click_count = game->click_count;
+  record.bbbv = game_board->bbbv;
+  record.width = game_board->width;
+  record.height = game_board->height;
+  record.difficulty = stats_get_difficulty(game_board->width, game_board->height);
+  record.outcome = game->game_state == GAME_STATE_GAME_WON
+    ? STATS_OUTCOME_WON
+    : STATS_OUTCOME_LOST;
+  stats_append(stats, &record);
+}
+
+
+const struct StatsSummary* stats_get_summary(
+    struct Stats* stats,
+    enum StatsDifficulty difficulty
+) {
+  if (stats->index == NULL) return NULL;
+  return &stats->index->summaries[difficulty];
+}
+
+
+void stats_select_next(struct Stats* stats, int direction) {
+  stats->difficulty = (stats->difficulty + STATS_DIFFICULTY_MAX + direction) % STATS_DIFFICULTY_MAX;
+}
+
+
+void stats_print(struct Stats* stats, FILE* file) {
+  if (stats->index == NULL) return;
+  fprintf(file, "games=%lu\n", stats->index->record_count);
+  for (int difficulty = 0; difficulty < STATS_DIFFICULTY_MAX; difficulty++) {
+    const struct StatsSummary* summary = &stats->index->summaries[difficulty];
+    fprintf(
+        file,
+        "%s: played=%lu won=%lu streak=%u best_streak=%u\n",
+        stats_get_difficulty_name(difficulty),
+        summary->played_count,
+        summary->won_count,
+        summary->streak,
+        summary->best_streak
+    );
+    for (int i = 0; i < summary->leaderboard_size; i++) {
+      const struct StatsLeaderboardEntry* entry = &summary->leaderboard[i];
+      fprintf(
+          file,
+          "  %d. time_ms=%u clicks=%u 3bv=%u finished_at=%ld\n",
+          i + 1,
+          entry->time_ms,
+          entry->click_count,
+          entry->bbbv,
+          entry->finished_at
+      );
+    }
+  }
+}
+
+
+void stats_close(struct Stats* stats) {
+  if (stats->index != NULL) {
+    munmap(stats->index, sizeof(struct StatsIndex));
+    stats->index = NULL;
+  }
+  if (stats->log_fd != -1) {
+    close(stats->log_fd);
+    stats->log_fd = -1;
+  }
+}
@@ -0,0 +1,114 @@
+#ifndef STATS_H
+#define STATS_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "game.h"
+
+
+#define STATS_FILE_ENV "MINESWEEPER_STATS"
+#define STATS_FILE_NAME ".minesweeper_stats"
+#define STATS_INDEX_SUFFIX ".idx"
+#define STATS_PATH_MAX 1024
+#define STATS_LOG_MAGIC "MSSTATS1"
+#define STATS_INDEX_MAGIC "MSSTIDX1"
+#define STATS_LEADERBOARD_SIZE 5
+
+
+enum StatsDifficulty {
+  STATS_DIFFICULTY_EASY,
+  STATS_DIFFICULTY_MEDIUM,
+  STATS_DIFFICULTY_HARD,
+  STATS_DIFFICULTY_CUSTOM,
+  STATS_DIFFICULTY_MAX
+};
+
+
+enum StatsOutcome {
+  STATS_OUTCOME_LOST,
+  STATS_OUTCOME_WON
+};
+
+
+/**
+ * One finished game, as appended to the log.
+ */
+struct StatsRecord {
+  int64_t finished_at;
+  uint32_t seed;
+  uint32_t time_ms;
+  uint32_t click_count;
+  uint16_t bbbv;
+  uint8_t width;
+  uint8_t height;
+  uint8_t difficulty;
+  uint8_t outcome;
+  uint8_t padding[6];
+};
+
+
+struct StatsLeaderboardEntry {
+  uint32_t time_ms;
+  uint32_t click_count;
+  uint16_t bbbv;
+  uint8_t padding[6];
+  int64_t finished_at;
+};
+
+
+struct StatsSummary {
+  uint64_t played_count;
+  uint64_t won_count;
+  uint32_t streak;
+  uint32_t best_streak;
+  uint32_t leaderboard_size;
+  // Fastest wins first.
+  struct StatsLeaderboardEntry leaderboard[STATS_LEADERBOARD_SIZE];
+};
+
+
+/**
+ * Everything the stats screen shows, folded from the log one record at a
+ * time. It is a cache: when it is missing, stale or covers more records
+ * than the log holds, it is rebuilt from the log.
+ */
+struct StatsIndex {
+  char magic[8];
+  uint64_t record_count;
+  struct StatsSummary summaries[STATS_DIFFICULTY_MAX];
+};
+
+
+/**
+ * Finished games are appended to a binary log, $MINESWEEPER_STATS or
+ * ~/.minesweeper_stats, and folded into an index mapped from the file
+ * next to it. Queries read the mapped index, so they cost the same after
+ * millions of games.
+ */
+struct Stats {
+  int log_fd;
+  struct StatsIndex* index;
+  // Shown by the stats screen.
+  enum StatsDifficulty difficulty;
+};
+
+
+void stats_init(struct Stats* stats);
+bool stats_open(struct Stats* stats, const char* log_path);
+void stats_open_user_file(struct Stats* stats);
+enum StatsDifficulty stats_get_difficulty(int width, int height);
+const char* stats_get_difficulty_name(enum StatsDifficulty difficulty);
+void stats_record_game(struct Stats* stats, struct Game* game, long now_ms);
+bool stats_append(struct Stats* stats, const struct StatsRecord* record);
+const struct StatsSummary* stats_get_summary(
+    struct Stats* stats,
+    enum StatsDifficulty difficulty
+);
+void stats_select_next(struct Stats* stats, int direction);
+void stats_print(struct Stats* stats, FILE* file);
+void stats_close(struct Stats* stats);
+
+
+#endif
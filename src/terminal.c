@@ -1,8 +1,14 @@
 #include "terminal.h"
 
 
-void terminal_init(struct Terminal* terminal) {
-  getmaxyx(stdscr, terminal->height, terminal->width);
+int g_term_tty_fd = -1;
+
+
+void terminal_init(struct Terminal* terminal, int width, int height) {
+  terminal->width = width;
+  terminal->height = height;
+  terminal->center = terminal_center(terminal);
+  terminal->is_too_small = terminal->height < TERMINAL_MIN_HEIGHT;
 }
 
 
@@ -14,61 +20,81 @@ struct Vector terminal_center(struct Terminal* terminal) {
 }
 
 
-struct Vector term_get_size(void) {
-  struct Vector empty_vector;
-  empty_vector.x = 0;
-  empty_vector.y = 0;
+/**
+ * Open the controlling tty and load its terminfo entry.
+ * Only done on the first call, the descriptor is kept for later calls.
+ */
+bool term_setup(void) {
+  if (g_term_tty_fd != -1) return true;
 
   char const *const term = getenv("TERM");
   if (term == NULL) {
     log_fatal("TERM environment variable not set\n" );
-    return empty_vector;
+    return false;
   }
   log_info_f("TERM=%s", term);
 
   char const *const cterm_path = ctermid(NULL);
   if (cterm_path == NULL || cterm_path[0] == '\0') {
     log_fatal("ctermid() failed\n");
-    return empty_vector;
+    return false;
   }
   log_info_f("cterm_path=%s", cterm_path);
 
   int tty_fd = open(cterm_path, O_RDWR);
   if (tty_fd == -1) {
     log_fatal_f("open(\"%s\") failed (%d): %s\n", cterm_path, errno, strerror(errno));
-    return empty_vector;
+    return false;
   }
 
   int setupterm_err;
   if (setupterm((char*)term, tty_fd, &setupterm_err) == ERR) {
+    close(tty_fd);
     switch (setupterm_err) {
       case -1:
         log_fatal("setupterm() failed: terminfo database not found\n");
-        goto cleanup;
+        return false;
       case 0:
         log_fatal_f("setupterm() failed: TERM=%s not found in database\n", term);
-        goto cleanup;
+        return false;
       case 1:
         log_fatal("setupterm() failed: terminal is hardcopy\n");
-        goto cleanup;
+        return false;
     } // switch
+    return false;
   }
 
-  int cols = tigetnum("cols");
-  if (cols < 0) {
-    log_fatal_f("tigetnum(\"cols\") failed (%d)\n", cols);
-  }
+  g_term_tty_fd = tty_fd;
+  return true;
+}
 
-  int l = tigetnum("lines");
-  if (l < 0) {
-    log_fatal_f("tigetnum(\"lines\") failed (%d)\n", l);
-  }
 
-cleanup:
-  if (tty_fd != -1) close(tty_fd);
+struct Vector term_get_size(void) {
   struct Vector v;
-  v.x = cols < 0 ? 0 : cols;
-  v.y = l < 0 ? 0 : l;
+  v.x = 0;
+  v.y = 0;
+
+  if (!term_setup()) return v;
+
+  // The kernel knows the current size, terminfo only the default one.
+  struct winsize ws;
+  if (ioctl(g_term_tty_fd, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0) {
+    v.x = ws.ws_col;
+    v.y = ws.ws_row;
+  } else {
+    int cols = tigetnum("cols");
+    if (cols < 0) {
+      log_fatal_f("tigetnum(\"cols\") failed (%d)\n", cols);
+    }
+
+    int l = tigetnum("lines");
+    if (l < 0) {
+      log_fatal_f("tigetnum(\"lines\") failed (%d)\n", l);
+    }
+
+    v.x = cols < 0 ? 0 : cols;
+    v.y = l < 0 ? 0 : l;
+  }
 
   char buf[256];
   vector_as_string(buf, v);
@@ -12,16 +12,26 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/ioctl.h>
+#include <stdbool.h>
+#include "consts.h"
 
 
+/**
+ * Terminal size and the layout derived from it.
+ * Only recomputed by `terminal_init` when the terminal is resized.
+ */
 struct Terminal {
   int width;
   int height;
+  struct Vector center;
+  bool is_too_small;
 };
 
 
-void terminal_init(struct Terminal* terminal);
+void terminal_init(struct Terminal* terminal, int width, int height);
 struct Vector terminal_center(struct Terminal* terminal);
+bool term_setup(void);
 struct Vector term_get_size(void);
 
 
@@ -0,0 +1,124 @@
+#include "trace.h"
+#include "log.h"
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+
+_Static_assert(sizeof(struct TraceEvent) == 16, "Trace events must stay 16 bytes.");
+
+
+const char* g_trace_names[TRACE_NAME_MAX] = {
+  [TRACE_NAME_WAIT] = "event_loop_wait",
+  [TRACE_NAME_TERMINAL_INIT] = "terminal_init",
+  [TRACE_NAME_RENDER] = "render",
+  [TRACE_NAME_RENDER_ANIMATION] = "render_reveal_animation",
+  [TRACE_NAME_INPUT_UPDATE] = "input_update",
+  [TRACE_NAME_UPDATE_GAME] = "main_update_game",
+  [TRACE_NAME_SETUP_GAME] = "game_board_setup_game",
+  [TRACE_NAME_PLAY_CELL] = "game_board_play_cell",
+};
+
+
+bool g_trace_enable = false;
+int g_trace_fd = -1;
+
+// Each thread fills its own buffer, so recording needs no synchronization.
+_Thread_local struct TraceEvent g_trace_events[TRACE_BUFFER_EVENTS];
+_Thread_local int g_trace_event_count = 0;
+_Thread_local uint32_t g_trace_thread_id = 0;
+
+
+/**
+ * Start tracing when $MINESWEEPER_TRACE names the file to write.
+ */
+void trace_init() {
+  const char* path = getenv(TRACE_FILE_ENV);
+  if (path == NULL) return;
+  g_trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+  if (g_trace_fd < 0) {
+    log_fatal_f("open(\"%s\") failed (%d): %s\n", path, errno, strerror(errno));
+  }
+  if (write(g_trace_fd, TRACE_MAGIC, strlen(TRACE_MAGIC)) < 0) {
+    log_fatal_f("write() failed (%d): %s\n", errno, strerror(errno));
+  }
+  g_trace_enable = true;
+  atexit(trace_close);
+  log_info_f("Tracing to %s", path);
+}
+
+
+/**
+ * Write the events of the calling thread. A whole buffer goes out in one
+ * append so threads never interleave inside an event.
+ */
+void trace_flush() {
+  if (g_trace_fd < 0 || g_trace_event_count == 0) return;
+  size_t size = g_trace_event_count * sizeof(struct TraceEvent);
+  if (write(g_trace_fd, g_trace_events, size) != (ssize_t)size) {
+    log_error_f("Trace write failed (%d): %s", errno, strerror(errno));
+  }
+  g_trace_event_count = 0;
+}
+
+
+void trace_record(enum TraceName name, int phase) {
+  if (g_trace_thread_id == 0) g_trace_thread_id = syscall(SYS_gettid);
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  struct TraceEvent* event = &g_trace_events[g_trace_event_count++];
+  event->timestamp_ns = (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+  event->thread_id = g_trace_thread_id;
+  event->name = name;
+  event->phase = phase;
+  event->padding = 0;
+  if (g_trace_event_count == TRACE_BUFFER_EVENTS) trace_flush();
+}
+
+
+void trace_close() {
+  if (g_trace_fd < 0) return;
+  trace_flush();
+  g_trace_enable = false;
+  close(g_trace_fd);
+  g_trace_fd = -1;
+}
+
+
+/**
+ * Turn a binary trace into the Chrome trace event JSON format, which
+ * chrome://tracing and Perfetto both open.
+ */
+bool trace_convert_to_json(FILE* input, FILE* output) {
+  char magic[sizeof(TRACE_MAGIC) - 1];
+  if (fread(magic, 1, sizeof(magic), input) != sizeof(magic)
+      || memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0
+  ) {
+    log_error("Not a trace file.");
+    return false;
+  }
+
+  struct TraceEvent events[TRACE_BUFFER_EVENTS];
+  bool first = true;
+  size_t count;
+  fprintf(output, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  while ((count = fread(events, sizeof(struct TraceEvent), TRACE_BUFFER_EVENTS, input)) > 0) {
+    for (size_t i = 0; i < count; i++) {
+      struct TraceEvent* event = &events[i];
+      if (event->name >= TRACE_NAME_MAX) continue;
+      fprintf(
+          output,
+          "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+          first ? "" : ",",
+          g_trace_names[event->name],
+          event->phase,
+          (double)event->timestamp_ns / 1000.0,
+          event->thread_id
+      );
+      first = false;
+    }
+  }
+  fprintf(output, "\n]}\n");
+  return true;
+}
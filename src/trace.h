@@ -0,0 +1,64 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+#define TRACE_FILE_ENV "MINESWEEPER_TRACE"
+#define TRACE_MAGIC "MSTRACE1"
+// Events buffered per thread before they are written to the trace file.
+#define TRACE_BUFFER_EVENTS 4096
+
+#define TRACE_PHASE_BEGIN 'B'
+#define TRACE_PHASE_END 'E'
+
+
+enum TraceName {
+  TRACE_NAME_WAIT,
+  TRACE_NAME_TERMINAL_INIT,
+  TRACE_NAME_RENDER,
+  TRACE_NAME_RENDER_ANIMATION,
+  TRACE_NAME_INPUT_UPDATE,
+  TRACE_NAME_UPDATE_GAME,
+  TRACE_NAME_SETUP_GAME,
+  TRACE_NAME_PLAY_CELL,
+  TRACE_NAME_MAX
+};
+
+
+/**
+ * Fixed size record of the trace file, after the magic.
+ */
+struct TraceEvent {
+  uint64_t timestamp_ns;
+  uint32_t thread_id;
+  uint16_t name;
+  uint8_t phase;
+  uint8_t padding;
+};
+
+
+extern bool g_trace_enable;
+
+
+// Trace points cost one branch when tracing is off.
+#define trace_begin(name) { \
+  if (g_trace_enable) trace_record(name, TRACE_PHASE_BEGIN); \
+}
+
+#define trace_end(name) { \
+  if (g_trace_enable) trace_record(name, TRACE_PHASE_END); \
+}
+
+
+void trace_init();
+void trace_record(enum TraceName name, int phase);
+void trace_flush();
+void trace_close();
+bool trace_convert_to_json(FILE* input, FILE* output);
+
+
+#endif
@@ -3,14 +3,10 @@
 
 #define UI_MENU_WIDTH 31
 #define UI_MENU_HEIGHT 15
-
-
-void ui_init_ncurses() {
-  initscr();
-  noecho();
-  cbreak();
-  keypad(stdscr, TRUE);
-}
+#define UI_MINIMAP_WIDTH 22
+#define UI_MINIMAP_HEIGHT 12
+#define UI_HUD_WIDTH 26
+#define UI_HUD_HEIGHT (METRIC_ID_MAX + 3)
 
 
 void ui_game_over_init(struct WindowManager* window_manager) {
@@ -37,14 +33,62 @@ void ui_menu_init(struct WindowManager* window_manager) {
 }
 
 
-void ui_init(struct UI* ui) {
-  ui_init_ncurses();
-  window_manager_init(&ui->window_manager);
+void ui_minimap_init(struct WindowManager* window_manager, struct Minimap* minimap) {
+  window_manager_set_width(window_manager, WINDOW_ID_MINIMAP, UI_MINIMAP_WIDTH);
+  window_manager_set_height(window_manager, WINDOW_ID_MINIMAP, UI_MINIMAP_HEIGHT);
+  minimap_init(minimap, UI_MINIMAP_WIDTH - 2, UI_MINIMAP_HEIGHT - 2);
+}
+
+
+void ui_hud_init(struct WindowManager* window_manager, struct Metrics* metrics) {
+  window_manager_set_width(window_manager, WINDOW_ID_HUD, UI_HUD_WIDTH);
+  window_manager_set_height(window_manager, WINDOW_ID_HUD, UI_HUD_HEIGHT);
+  metrics_init(metrics);
+}
+
+
+void ui_layout(struct UI* ui) {
+  struct Terminal* terminal = &ui->terminal;
+  int width;
+  int height;
+  render_backend_get_size(ui->render_backend, &width, &height);
+  trace_begin(TRACE_NAME_TERMINAL_INIT);
+  terminal_init(terminal, width, height);
+  trace_end(TRACE_NAME_TERMINAL_INIT);
+  log_info_f("terminal={width:%d, height:%d}", terminal->width, terminal->height);
+  window_manager_layout(&ui->window_manager, terminal->center.x, terminal->center.y);
+  // The minimap sits in the top right corner, below the help line.
+  window_manager_move(
+      &ui->window_manager,
+      WINDOW_ID_MINIMAP,
+      terminal->width - UI_MINIMAP_WIDTH,
+      1
+  );
+  // The performance overlay sits in the bottom left corner.
+  window_manager_move(
+      &ui->window_manager,
+      WINDOW_ID_HUD,
+      0,
+      terminal->height - UI_HUD_HEIGHT
+  );
+}
+
+
+void ui_init(struct UI* ui, struct RenderBackend* render_backend) {
+  ui->render_backend = render_backend;
+  window_manager_init(&ui->window_manager, render_backend);
   ui_game_over_init(&ui->window_manager);
   ui_game_won_init(&ui->window_manager);
   ui_game_menu_init(&ui->window_manager);
   ui_menu_init(&ui->window_manager);
+  ui_minimap_init(&ui->window_manager, &ui->minimap);
+  ui_hud_init(&ui->window_manager, &ui->metrics);
   menu_init(&ui->menu, &ui->window_manager);
   game_menu_init_new_game(&ui->game_menu);
   manual_init(&ui->manual);
+  reveal_animation_init(&ui->reveal_animation);
+  key_binding_init(&ui->key_binding);
+  recorder_init(&ui->recorder);
+  stats_init(&ui->stats);
+  ui_layout(ui);
 }
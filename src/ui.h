@@ -7,21 +7,37 @@
 #include "window_manager.h"
 #include "terminal.h"
 #include "manual.h"
+#include "minimap.h"
+#include "render_backend.h"
+#include "reveal_animation.h"
+#include "key_binding.h"
+#include "trace.h"
+#include "metrics.h"
+#include "recorder.h"
+#include "stats.h"
 
 
 /**
  * This struct is expected to contain all UI singletons.
  */
 struct UI {
+  struct RenderBackend* render_backend;
   struct Menu menu;
   struct ItemSelection game_menu;
   struct WindowManager window_manager;
   struct Terminal terminal;
   struct Manual manual;
+  struct Minimap minimap;
+  struct RevealAnimation reveal_animation;
+  struct KeyBinding key_binding;
+  struct Metrics metrics;
+  struct Recorder recorder;
+  struct Stats stats;
 };
 
 
-void ui_init(struct UI* ui);
+void ui_init(struct UI* ui, struct RenderBackend* render_backend);
+void ui_layout(struct UI* ui);
 
 
 #endif
@@ -7,9 +7,12 @@
 #define WINDOW_MANAGER_WINDOW_HEIGHT 15
 
 
-void window_manager_init(struct WindowManager* window_manager) {
+void window_manager_init(
+    struct WindowManager* window_manager,
+    struct RenderBackend* render_backend
+) {
+  window_manager->render_backend = render_backend;
   for (int i = 0; i < WINDOW_ID_MAX; i++) {
-    window_manager->window[i] = newwin(0, 0, 0, 0);
     window_manager->width[i] = WINDOW_MANAGER_WINDOW_WIDTH;
     window_manager->height[i] = WINDOW_MANAGER_WINDOW_HEIGHT;
     window_manager->left[i] = 0;
@@ -86,46 +89,75 @@ void window_manager_set_height(
 }
 
 
-WINDOW* window_manager_get_window(
-    struct WindowManager* window_manager,
-    enum WindowId window_id
-) {
-  return window_manager->window[window_id];
-}
-
-
 void window_manager_erase(struct WindowManager* window_manager) {
   for (int i = 0; i < WINDOW_ID_MAX; i++) {
-    werase(window_manager->window[i]);
     window_manager->enable[i] = false;
   }
 }
 
 
-WINDOW* window_manager_setup_window(
+/**
+ * Place every window around the center of the terminal.
+ * Only needs to be called again when the terminal is resized.
+ */
+void window_manager_layout(
     struct WindowManager* window_manager,
-    enum WindowId window_id,
     int center_x,
     int center_y
 ) {
-  window_manager->enable[window_id] = true;
-  window_manager->left[window_id] = center_x - window_manager->width[window_id] / 2;
-  window_manager->top[window_id] = center_y - window_manager->height[window_id] / 2;
+  for (int i = 0; i < WINDOW_ID_MAX; i++) {
+    window_manager->left[i] = center_x - window_manager->width[i] / 2;
+    window_manager->top[i] = center_y - window_manager->height[i] / 2;
+    window_manager_print(window_manager, i);
+  }
+}
+
+
+void window_manager_move(
+    struct WindowManager* window_manager,
+    enum WindowId window_id,
+    int left,
+    int top
+) {
+  window_manager->left[window_id] = left;
+  window_manager->top[window_id] = top;
   window_manager_print(window_manager, window_id);
-  WINDOW* window = window_manager->window[window_id];
-  wresize(window, window_manager->height[window_id], window_manager->width[window_id]);
-  mvwin(window, window_manager->top[window_id], window_manager->left[window_id]);
-  box(window, 0, 0);
-  return window;
 }
 
 
-/**
- * This function should be called last.
- */
-void window_manager_render(struct WindowManager* window_manager) {
-  for (int i = 0; i < WINDOW_ID_MAX; i++) {
-    if (!window_manager->enable[i]) continue;
-    wrefresh(window_manager->window[i]);
-  }
+void window_manager_setup_window(
+    struct WindowManager* window_manager,
+    enum WindowId window_id
+) {
+  window_manager->enable[window_id] = true;
+  render_backend_open_window(
+      window_manager->render_backend,
+      window_id,
+      window_manager->left[window_id],
+      window_manager->top[window_id],
+      window_manager->width[window_id],
+      window_manager->height[window_id]
+  );
+}
+
+
+void window_manager_put_char(
+    struct WindowManager* window_manager,
+    enum WindowId window_id,
+    int y,
+    int x,
+    int c
+) {
+  render_backend_put_char(window_manager->render_backend, window_id, y, x, c);
+}
+
+
+void window_manager_put_string(
+    struct WindowManager* window_manager,
+    enum WindowId window_id,
+    int y,
+    int x,
+    const char* text
+) {
+  render_backend_put_string(window_manager->render_backend, window_id, y, x, text);
 }
@@ -2,8 +2,8 @@
 #define WINDOW_MANAGER_H
 
 
-#include <curses.h>
-#include <ncurses.h>
+#include <stdbool.h>
+#include "render_backend.h"
 
 
 enum WindowId {
@@ -12,12 +12,15 @@ enum WindowId {
   WINDOW_ID_MENU,
   WINDOW_ID_GAME_MENU,
   WINDOW_ID_MANUAL,
+  WINDOW_ID_MINIMAP,
+  WINDOW_ID_HUD,
+  WINDOW_ID_STATS,
   WINDOW_ID_MAX
 };
 
 
 struct WindowManager {
-  WINDOW* window[WINDOW_ID_MAX];
+  struct RenderBackend* render_backend;
   int width[WINDOW_ID_MAX];
   int height[WINDOW_ID_MAX];
   int left[WINDOW_ID_MAX];
@@ -26,7 +29,10 @@ struct WindowManager {
 };
 
 
-void window_manager_init(struct WindowManager* window_manager);
+void window_manager_init(
+    struct WindowManager* window_manager,
+    struct RenderBackend* render_backend
+);
 void window_manager_set_left(
    struct WindowManager* window_manager,
    enum WindowId window_id,
@@ -55,18 +61,36 @@ void window_manager_set_height(
     enum WindowId window_id,
     int height
 );
-WINDOW* window_manager_get_window(
+void window_manager_erase(struct WindowManager* window_manager);
+void window_manager_layout(
+    struct WindowManager* window_manager,
+    int center_x,
+    int center_y
+);
+void window_manager_move(
+    struct WindowManager* window_manager,
+    enum WindowId window_id,
+    int left,
+    int top
+);
+void window_manager_setup_window(
     struct WindowManager* window_manager,
     enum WindowId window_id
 );
-void window_manager_erase(struct WindowManager* window_manager);
-WINDOW* window_manager_setup_window(
+void window_manager_put_char(
     struct WindowManager* window_manager,
     enum WindowId window_id,
-    int center_x,
-    int center_y
+    int y,
+    int x,
+    int c
+);
+void window_manager_put_string(
+    struct WindowManager* window_manager,
+    enum WindowId window_id,
+    int y,
+    int x,
+    const char* text
 );
-void window_manager_render(struct WindowManager* window_manager);
 
 
 #endif